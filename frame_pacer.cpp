@@ -0,0 +1,89 @@
+#include "frame_pacer.hpp"
+#include <iomanip>
+
+frame_pacer::frame_pacer(int fps_cap) : freq(static_cast<double>(SDL_GetPerformanceFrequency())) {
+	set_cap(fps_cap);
+	frame_start = SDL_GetPerformanceCounter();
+}
+
+void frame_pacer::set_cap(int fps) {
+	cap = fps > 0 ? fps : 0;
+	frame_ticks = cap ? static_cast<Uint64>(freq / cap) : 0;
+	deadline = 0; // resync on the next frame
+}
+
+double frame_pacer::begin_frame() {
+	const Uint64 now = SDL_GetPerformanceCounter();
+	const double dt = static_cast<double>(now - frame_start) / freq;
+	if (!fresh) record(dt * 1000.0);
+	fresh = false;
+	frame_start = now;
+
+	if (frame_ticks) {
+		// next deadline follows the previous one so rounding doesn't drift, unless we fell a whole frame behind
+		if (deadline == 0 || now > deadline + frame_ticks) deadline = now + frame_ticks;
+		else deadline += frame_ticks;
+	}
+	return dt;
+}
+
+void frame_pacer::end_frame() {
+	if (!frame_ticks) return;
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (now >= deadline) return;
+
+	const double remaining_ms = static_cast<double>(deadline - now) * 1000.0 / freq;
+	if (remaining_ms > spin_ms) {
+		SDL_DelayNS(static_cast<Uint64>((remaining_ms - spin_ms) * 1e6));
+	}
+	while (SDL_GetPerformanceCounter() < deadline) {} // last stretch, sleep granularity is too coarse here
+}
+
+void frame_pacer::restart() {
+	frame_start = SDL_GetPerformanceCounter();
+	fresh = true;
+	deadline = 0;
+}
+
+void frame_pacer::record(double ms) {
+	size_t bin = static_cast<size_t>(ms / bin_ms);
+	if (bin >= bin_count) bin = bin_count - 1;
+	++bins[bin];
+	++frames;
+	if (ms > max_ms) max_ms = ms;
+}
+
+double frame_pacer::percentile(double p) const {
+	if (frames == 0) return 0.0;
+	const size_t rank = static_cast<size_t>(p * static_cast<double>(frames - 1)) + 1; // 1-based
+	size_t seen = 0;
+	for (size_t i = 0; i < bin_count; ++i) {
+		seen += bins[i];
+		if (seen >= rank) return (i == bin_count - 1) ? max_ms : (i + 1) * bin_ms;
+	}
+	return max_ms;
+}
+
+frame_time_stats frame_pacer::stats() const {
+	frame_time_stats s;
+	s.frames = frames;
+	s.p50_ms = percentile(0.50);
+	s.p95_ms = percentile(0.95);
+	s.p99_ms = percentile(0.99);
+	s.max_ms = max_ms;
+	return s;
+}
+
+void frame_pacer::reset_stats() {
+	bins.fill(0);
+	frames = 0;
+	max_ms = 0;
+}
+
+void frame_pacer::dump(std::ostream& out) const {
+	const frame_time_stats s = stats();
+	out << std::fixed << std::setprecision(2)
+		<< "frame times (" << s.frames << " frames, cap " << (cap ? std::to_string(cap) + " fps" : std::string("off")) << "): "
+		<< "p50 " << s.p50_ms << " ms, p95 " << s.p95_ms << " ms, p99 " << s.p99_ms << " ms, max " << s.max_ms << " ms"
+		<< std::defaultfloat << std::endl;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef frame_pacer_hpp
+#define frame_pacer_hpp
+#include <iostream>
+#include <array>
+#include <SDL3/SDL.h>
+
+struct frame_time_stats {
+	size_t frames = 0;
+	double p50_ms = 0, p95_ms = 0, p99_ms = 0;
+	double max_ms = 0;
+};
+
+// Caps the frame rate against an absolute deadline: sleeps until spin_ms before it, then spins on the
+// performance counter, so the cap holds to well under a millisecond. Also keeps a histogram of frame intervals.
+class frame_pacer {
+	static constexpr double bin_ms = 0.1;        // histogram resolution
+	static constexpr size_t bin_count = 1000;    // 0 - 100 ms, longer frames land in the last bin
+	static constexpr double spin_ms = 1.5;       // left for spinning, covers scheduler wake-up latency
+
+	double freq;
+	Uint64 frame_ticks = 0;  // target interval in counter ticks, 0 = uncapped
+	Uint64 deadline = 0;
+	Uint64 frame_start = 0;
+	bool fresh = true;       // frame_start isn't a previous frame (first frame, after idle)
+	int cap = 0;
+
+	std::array<Uint32, bin_count> bins{};
+	size_t frames = 0;
+	double max_ms = 0;
+
+	void record(double ms);
+public:
+	explicit frame_pacer(int fps_cap = 0);
+
+	void set_cap(int fps); // 0 = uncapped (benchmark)
+	int get_cap() const { return cap; }
+
+	double begin_frame(); // seconds since the previous begin_frame, recorded in the histogram
+	void end_frame();     // waits for the cap deadline, returns at once when uncapped
+	void restart();       // after an idle wait: the gap isn't a frame, the next begin_frame starts fresh
+
+	double percentile(double p) const; // p in 0..1, in ms, upper edge of the bin
+	frame_time_stats stats() const;
+	void reset_stats();
+	void dump(std::ostream& out) const;
+};
+
+#endif
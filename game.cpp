@@ -36,6 +36,16 @@ void Game::init(const char* title, int xpos, int ypos, int width, int height, bo
 		return;
 	}
 
+	// pre-decoded pack if there is an up to date one (built with --pack), otherwise decode the folders on worker threads
+	// while the window, renderer and fonts come up
+	tex_mgr.set_atlas_mode(true);
+	tex_mgr.set_memory_budget(256u << 20); // unreferenced textures past this are evicted and reloaded on demand
+	const bool packed = tex_mgr.open_pack(asset_pack_path, asset_folders);
+	if (!packed) tex_mgr.begin_async_load(asset_folders);
+#ifdef _DEBUG
+	if (!packed) tex_mgr.enable_hot_reload(asset_folders); // edited art shows up without a restart
+#endif
+
 	int target_w = width;
 	int target_h = height;
 	int target_x = -1, target_y = -1;
@@ -110,8 +120,13 @@ void Game::init(const char* title, int xpos, int ypos, int width, int height, bo
 	}
 
 	tex_mgr.set_renderer(renderer);
-	tex_mgr.load_textures_from_folder("assets");
-	tex_mgr.load_textures_from_folder("assets/sprites");
+	if (!packed || !tex_mgr.upload_pack()) {
+		if (packed) {
+			for (const auto& folder : asset_folders) tex_mgr.load_textures_from_folder(folder);
+		}
+		std::cout << "images decoded before upload: " << static_cast<int>(tex_mgr.async_progress() * 100) << "%" << std::endl;
+		tex_mgr.finish_async_load();
+	}
 
 	file_managemenet::read_data(players);
 	players.set_current_player_id(1);
@@ -127,16 +142,18 @@ void Game::init(const char* title, int xpos, int ypos, int width, int height, bo
 	streched_bg_obj& floppa = *obj_container.get<streched_bg_obj>("-");
 	floppa.init("floppa", tex_mgr, screen_w, screen_h);
 
-	tex_mgr.create_text_texture("title", "fonts/ARIAL.TTF", 72, "FLOPPA ROCK PAPER SCISSORS", Colors::red);
+	// text styles, every label below is rasterized exactly once
+	const std::string font = "fonts/ARIAL.TTF";
+	const text_style button_style = text_style(font, 48).fg(Colors::white).background(Colors::light_grey, 4, 4).border(Colors::black, 2).as_layered();
+	const text_style counter_style = text_style(font, 48).fg(Colors::black).as_glyphs();
+
+	tex_mgr.create_text("title", "FLOPPA ROCK PAPER SCISSORS", text_style(font, 72).fg(Colors::red));
 	obj_container.spawn_as<Button>("title", "title", tex_mgr, middle.x - ((tex_mgr.get_texture("title")->w / 2) * screen_scale_factor), (middle.y - (tex_mgr.get_texture("title")->h / 2)) / 16, screen_scale_factor, true, 10);
 
-	tex_mgr.create_text_texture("finish_text", "fonts/ARIAL.TTF", 48, "SAVE & QUIT", Colors::red);
-	tex_mgr.set_text_background("finish_text", true, Colors::white, 4, 4);
-	tex_mgr.set_text_border("finish_text", true, Colors::black, 2);
-	obj_container.spawn_as<Text_Button>("finish_text", "finish_text", tex_mgr, screen_w - tex_mgr.get_texture("finish_text")->w * 2 - percent.x, percent.y, screen_scale_factor, true, 9, 4);
+	tex_mgr.create_text("finish_text", "SAVE & QUIT", text_style(button_style).fg(Colors::red).background(Colors::white, 4, 4));
+	obj_container.spawn_as<Text_Button>("finish_text", "finish_text", tex_mgr, screen_w - tex_mgr.text_box_size("finish_text").x * 2 - percent.x, percent.y, screen_scale_factor, true, 9, 4);
 
-	tex_mgr.create_text_texture("player_name_text", "fonts/ARIAL.TTF", 64, "Logged in as: " + players.get_player(players.get_current_player_id())->name, Colors::black);
-	tex_mgr.set_text_background("player_name_text", true, Colors::white_seethru, 4, 4);
+	tex_mgr.create_text("player_name_text", "Logged in as: " + players.get_player(players.get_current_player_id())->name, text_style(font, 64).fg(Colors::black).background(Colors::white_seethru, 4, 4).as_layered());
 	obj_container.spawn_as<Text_Button>("player_name_text", "player_name_text", tex_mgr, percent.y, screen_scale_factor, true, 3, 0);
 	//------------------------------------------------------
 
@@ -145,90 +162,86 @@ void Game::init(const char* title, int xpos, int ypos, int width, int height, bo
 	streched_bg_obj& kadfloppa = *obj_container.get<streched_bg_obj>("kadfloppa");
 	kadfloppa.init("kadfloppa", tex_mgr, screen_w, screen_h);
 
-	obj_container.spawn_as<GameObject>("menu", "menu", tex_mgr, middle.x - ((tex_mgr.get_texture("menu")->w / 2) * screen_scale_factor), middle.y / 2, screen_scale_factor,true, 5);
+	obj_container.spawn_as<GameObject>("menu", "menu", tex_mgr, middle.x - ((tex_mgr.get_region("menu").src.w / 2) * screen_scale_factor), middle.y / 2, screen_scale_factor,true, 5);
 
-	tex_mgr.create_text_texture("start_text", "fonts/ARIAL.TTF", 72, "PLAY", Colors::white);
-	tex_mgr.set_text_background("start_text", true, Colors::green, 4, 4);
-	tex_mgr.set_text_border("start_text", true, Colors::black, 2);
-	obj_container.spawn_as<Text_Button>("start_text", "start_text", tex_mgr, (middle.x - (tex_mgr.get_texture("start_text")->w)), (middle.y + (middle.y / 2) + 6*percent.y), screen_scale_factor, true, 6, 5);
+	tex_mgr.create_text("start_text", "PLAY", text_style(button_style).size(72).background(Colors::green, 4, 4));
+	obj_container.spawn_as<Text_Button>("start_text", "start_text", tex_mgr, (middle.x - (tex_mgr.text_box_size("start_text").x)), (middle.y + (middle.y / 2) + 6*percent.y), screen_scale_factor, true, 6, 5);
 
 	size_t index = 0;
 	for (index = 0; index < players.get_vector().size(); index++) {
-		tex_mgr.create_text_texture("play_text" + index, "fonts/ARIAL.TTF", 48, players[index]->name, Colors::white);
 		int r_rand = rand() / 120;
 		int g_rand = rand() / 120;
 		int b_rand = rand() / 120;
 		SDL_Color bg_color = Colors::rgb(r_rand, g_rand, b_rand);
-		tex_mgr.set_text_background("play_text" + index, true, bg_color, 4, 4);
-		tex_mgr.set_text_border("play_text" + index, true, Colors::black, 2);
-		obj_container.spawn_as<Text_Button>("play_text" + index, "play_text" + index, tex_mgr, (middle.x - 1.5 * fifth.x), ((middle.y - 1.05 * fifth.y) + (tex_mgr.get_texture("play_text" + index)->h) * (2.5*index)), screen_scale_factor, true, 6, 100+index);
+		tex_mgr.create_text("play_text" + index, players[index]->name, text_style(button_style).background(bg_color, 4, 4));
+		obj_container.spawn_as<Text_Button>("play_text" + index, "play_text" + index, tex_mgr, (middle.x - 1.5 * fifth.x), ((middle.y - 1.05 * fifth.y) + (tex_mgr.text_box_size("play_text" + index).y) * (2.5*index)), screen_scale_factor, true, 6, 100+index);
 		cout << players[index]->name << std::endl;
 	}
 	//------------------------------------------------------
 
 	//play layer
-	tex_mgr.create_text_texture("rock_text", "fonts/ARIAL.TTF", 48, "ROCK", Colors::white);
-	tex_mgr.set_text_background("rock_text", true, Colors::light_grey, 4, 4);
-	tex_mgr.set_text_border("rock_text", true, Colors::black, 2);
-	obj_container.spawn_as<Text_Button>("rock_text", "rock_text", tex_mgr, middle.x - (middle.x / 2) - ((tex_mgr.get_texture("rock_text")->w / 2) * screen_scale_factor), (middle.y - (tex_mgr.get_texture("rock_text")->h / 2)) * 1.5, screen_scale_factor, true, 0, 0);
-
-	tex_mgr.create_text_texture("paper_text", "fonts/ARIAL.TTF", 48, "PAPER", Colors::white);
-	tex_mgr.set_text_background("paper_text", true, Colors::light_grey, 4, 4);
-	tex_mgr.set_text_border("paper_text", true, Colors::black, 2);
-	obj_container.spawn_as<Text_Button>("paper_text", "paper_text", tex_mgr, middle.x - ((tex_mgr.get_texture("paper_text")->w / 2) * screen_scale_factor), (middle.y - (tex_mgr.get_texture("paper_text")->h / 2)) * 1.5, screen_scale_factor, true, 0, 1);
-
-	tex_mgr.create_text_texture("scissors_text", "fonts/ARIAL.TTF", 48, "SCISSORS", Colors::white);
-	tex_mgr.set_text_background("scissors_text", true, Colors::light_grey, 4, 4);
-	tex_mgr.set_text_border("scissors_text", true, Colors::black, 2);
-	obj_container.spawn_as<Text_Button>("scissors_text", "scissors_text", tex_mgr, middle.x + (middle.x / 2) - ((tex_mgr.get_texture("scissors_text")->w / 2) * screen_scale_factor), (middle.y - (tex_mgr.get_texture("scissors_text")->h / 2)) * 1.5, screen_scale_factor, true, 0, 2);
-
-	tex_mgr.create_text_texture("main_menu_button", "fonts/ARIAL.TTF", 48, "MAIN MENU", Colors::white);
-	tex_mgr.set_text_background("main_menu_button", true, Colors::light_grey, 4, 4);
-	tex_mgr.set_text_border("main_menu_button", true, Colors::black, 2);
-	obj_container.spawn_as<Text_Button>("main_menu_button", "main_menu_button", tex_mgr, percent.x, (screen_h - (2 * tex_mgr.get_texture("main_menu_button")->h) - percent.y), screen_scale_factor, true, 0, 6);
+	tex_mgr.create_text("rock_text", "ROCK", button_style);
+	obj_container.spawn_as<Text_Button>("rock_text", "rock_text", tex_mgr, middle.x - (middle.x / 2) - ((tex_mgr.text_box_size("rock_text").x / 2) * screen_scale_factor), (middle.y - (tex_mgr.text_box_size("rock_text").y / 2)) * 1.5, screen_scale_factor, true, 0, 0);
+
+	tex_mgr.create_text("paper_text", "PAPER", button_style);
+	obj_container.spawn_as<Text_Button>("paper_text", "paper_text", tex_mgr, middle.x - ((tex_mgr.text_box_size("paper_text").x / 2) * screen_scale_factor), (middle.y - (tex_mgr.text_box_size("paper_text").y / 2)) * 1.5, screen_scale_factor, true, 0, 1);
+
+	tex_mgr.create_text("scissors_text", "SCISSORS", button_style);
+	obj_container.spawn_as<Text_Button>("scissors_text", "scissors_text", tex_mgr, middle.x + (middle.x / 2) - ((tex_mgr.text_box_size("scissors_text").x / 2) * screen_scale_factor), (middle.y - (tex_mgr.text_box_size("scissors_text").y / 2)) * 1.5, screen_scale_factor, true, 0, 2);
+
+	tex_mgr.create_text("main_menu_button", "MAIN MENU", button_style);
+	obj_container.spawn_as<Text_Button>("main_menu_button", "main_menu_button", tex_mgr, percent.x, (screen_h - (2 * tex_mgr.text_box_size("main_menu_button").y) - percent.y), screen_scale_factor, true, 0, 6);
 	//------------------------------------------------------
 
 	//results layer
-	tex_mgr.create_text_texture("extra_text", "fonts/ARIAL.TTF", 48, "PLAY AGAIN", Colors::white);
-	tex_mgr.set_text_background("extra_text", true, Colors::light_grey, 4, 4);
-	tex_mgr.set_text_border("extra_text", true, Colors::black, 2);
-	obj_container.spawn_as<Text_Button>("extra_text", "extra_text", tex_mgr, middle.x + (middle.x / 4), middle.y + (middle.y / 12), screen_scale_factor, false, 2, 3);
+	tex_mgr.create_text("extra_text", "PLAY AGAIN", button_style);
+	obj_container.spawn_as<Text_Button>("extra_text", "extra_text", tex_mgr, middle.x + (middle.x / 4), middle.y + (middle.y / 12), screen_scale_factor, true, 2, 3);
 
-	obj_container.spawn_as<sprite>("explosion", "-", tex_mgr, middle.x - (middle.x / 2), middle.y - (middle.y / 3 + 3*percent.y), screen_scale_factor * 0.2, false, 2);
+	obj_container.spawn_as<sprite>("explosion", "-", tex_mgr, middle.x - (middle.x / 2), middle.y - (middle.y / 3 + 3*percent.y), screen_scale_factor * 0.2, true, 2);
 
 	sprite& explosion = *obj_container.get<sprite>("explosion");
 
-	for (int i = 1;; ++i) {
-		std::string key = "sprites/s" + std::to_string(i);
-		if (!tex_mgr.has(key)) break;
-		explosion.add_element(key, tex_mgr);
+	anims.load(anim_clips_path, tex_mgr);
+	if (anims.find("explosion") == no_clip) { // no clip file: every sprites/sN frame, a quarter second each
+		anims.add_sequence("explosion", "sprites/s", 0.25f, anim_mode::loop, tex_mgr);
 	}
+	explosion.set_clip(anims, anims.find("explosion"));
 
-	obj_container.spawn_as<GameObject>("rock", "rock", tex_mgr, middle.x - (tex_mgr.get_texture("rock")->w / 2), middle.y - (middle.y / 3 + 3 * percent.y), screen_scale_factor * 0.2, false, 11);
-	obj_container.spawn_as<GameObject>("paper", "paper", tex_mgr, middle.x - (tex_mgr.get_texture("paper")->w / 2), middle.y - (middle.y / 3 + 3 * percent.y), screen_scale_factor * 0.2, false, 12);
-	obj_container.spawn_as<GameObject>("scissors", "scissors", tex_mgr, middle.x - (tex_mgr.get_texture("scissors")->w / 2), middle.y - (middle.y / 3 + 3 * percent.y), screen_scale_factor * 0.2, false, 13);
+	obj_container.spawn_as<GameObject>("rock", "rock", tex_mgr, middle.x - (tex_mgr.get_region("rock").src.w / 2), middle.y - (middle.y / 3 + 3 * percent.y), screen_scale_factor * 0.2, true, 11);
+	obj_container.spawn_as<GameObject>("paper", "paper", tex_mgr, middle.x - (tex_mgr.get_region("paper").src.w / 2), middle.y - (middle.y / 3 + 3 * percent.y), screen_scale_factor * 0.2, true, 12);
+	obj_container.spawn_as<GameObject>("scissors", "scissors", tex_mgr, middle.x - (tex_mgr.get_region("scissors").src.w / 2), middle.y - (middle.y / 3 + 3 * percent.y), screen_scale_factor * 0.2, true, 13);
 
-	obj_container.spawn_as<GameObject_cluster>("design", "design", tex_mgr, middle.x - ((tex_mgr.get_texture("title")->w / 2) * screen_scale_factor), (middle.y - (tex_mgr.get_texture("title")->h / 2)) / 3, screen_scale_factor, false, 1);
+	obj_container.spawn_as<GameObject_cluster>("design", "design", tex_mgr, middle.x - ((tex_mgr.get_texture("title")->w / 2) * screen_scale_factor), (middle.y - (tex_mgr.get_texture("title")->h / 2)) / 3, screen_scale_factor, true, 1);
 
-	tex_mgr.create_text_texture("result_text", "fonts/ARIAL.TTF", 48, "SCORE: NONE", Colors::black);
-	obj_container.spawn_as<Text_Button>("result_text", "result_text", tex_mgr, 0, 0, screen_scale_factor, false, -1);
+	// changes every round: glyph text, a new string only rebuilds a few quads
+	tex_mgr.create_text("result_text", "SCORE: NONE", counter_style);
+	obj_container.spawn_as<Text_Button>("result_text", "-", tex_mgr, 0, 0, screen_scale_factor, false, -1);
 
-	tex_mgr.create_text_texture("win_counter", "fonts/ARIAL.TTF", 48, "0", Colors::black);
-	obj_container.spawn_as<Text_Button>("win_counter", "win_counter", tex_mgr, 0, 0, screen_scale_factor, false, -1);
+	tex_mgr.create_text("win_counter", "0", counter_style);
+	obj_container.spawn_as<Text_Button>("win_counter", "-", tex_mgr, 0, 0, screen_scale_factor, false, -1);
 
-	tex_mgr.create_text_texture("tie_counter", "fonts/ARIAL.TTF", 48, "0", Colors::black);
-	obj_container.spawn_as<Text_Button>("tie_counter", "tie_counter", tex_mgr, 0, 0, screen_scale_factor, false, -1);
+	tex_mgr.create_text("tie_counter", "0", counter_style);
+	obj_container.spawn_as<Text_Button>("tie_counter", "-", tex_mgr, 0, 0, screen_scale_factor, false, -1);
 
-	tex_mgr.create_text_texture("lose_counter", "fonts/ARIAL.TTF", 48, "0", Colors::black);
-	obj_container.spawn_as<Text_Button>("lose_counter", "lose_counter", tex_mgr, 0, 0, screen_scale_factor, false, -1);
+	tex_mgr.create_text("lose_counter", "0", counter_style);
+	obj_container.spawn_as<Text_Button>("lose_counter", "-", tex_mgr, 0, 0, screen_scale_factor, false, -1);
 
 	GameObject_cluster& box = *obj_container.get<GameObject_cluster>("design");
 	box.add_item_local(*obj_container.get("result_text"), 2* percent.x, 3* percent.y, true);
 	box.add_item_local(*obj_container.get("win_counter"), (middle.x - 5*percent.x), 3 * percent.y, true);
 	box.add_item_local(*obj_container.get("tie_counter"), (middle.x - 5 * percent.x), (tenth.y + 1.5*percent.y), true);
 	box.add_item_local(*obj_container.get("lose_counter"), (middle.x - 5 * percent.x), (2*tenth.y - percent.y), true);
+	box.set_cached(true); // changes once per round, drawn as one quad in between
+	tex_mgr.set_text_listener([this](const std::string& text) { obj_container.wake_text(text); }); // text buttons sleep until their entry changes
 	//------------------------------------------------------
 
+	// layers 1, 2 and 11-13 (results) start hidden, scenes flip layers on and off relative to the current mask
+	obj_container.set_layer_mask(Game_obj_container::layer_set({ 0, 3, 4, 5, 6, 9, 10 }));
+	obj_container.define_scene("play", Game_obj_container::layer_set({ 0 }), Game_obj_container::layer_set({ 1, 2, 4, 5, 6, 11, 12, 13 }));
+	obj_container.define_scene("results", Game_obj_container::layer_set({ 1, 2 }), Game_obj_container::layer_set({ 4 }));
+	obj_container.define_scene("quit", 0, Game_obj_container::layer_set({ 0, 1, 2, 4, 9 }));
+	obj_container.define_scene("main_menu", Game_obj_container::layer_set({ 4, 5, 6, 9, 10 }), Game_obj_container::layer_set({ 1, 2 }));
+
 	run = true;
 }
 
@@ -240,6 +253,7 @@ void Game::set_cursors(SDL_Cursor* default_cursor_in, SDL_Cursor* pointer_cursor
 void Game::handleEvents() {
 	SDL_Event e;
 	while (SDL_PollEvent(&e)) {
+		redraw = true;
 		switch (e.type) {
 		case SDL_EVENT_QUIT:
 			run = false;
@@ -249,6 +263,9 @@ void Game::handleEvents() {
 				run = false;
 			}
 			break;
+		case SDL_EVENT_RENDER_TARGETS_RESET:
+			obj_container.invalidate_caches();
+			break;
 		case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
 			SDL_GetWindowSizeInPixels(window, &screen_w, &screen_h);
 			break;
@@ -268,20 +285,12 @@ void Game::handleEvents() {
 			}
 			obj_container.set_scale_all(screen_scale_factor);
 			break;
-		case SDL_EVENT_MOUSE_MOTION: {
-			SDL_FPoint W = WindowToWorld(renderer, e.motion.x, e.motion.y, cam);
+		case SDL_EVENT_MOUSE_MOTION:
 			//mouse.dx = e.motion.xrel, mouse.dy = e.motion.yrel; //currently unused commented out for performance
-			GameObject* hit = obj_container.pick_topmost(W.x, W.y);
-
-			if (hit != hovered) {
-				if (hovered) hovered->on_hover_exit(default_cursor);
-				hovered = hit;
-				if (hovered) hovered->on_hover_enter(pointer_cursor);
-			}
-			else if (hovered) {
-				hovered->on_hover();
-			}
-		}	break;
+			motion_x = e.motion.x;
+			motion_y = e.motion.y;
+			motion_pending = true;
+			break;
 		case SDL_EVENT_MOUSE_BUTTON_DOWN: {}
 			break;
 		case SDL_EVENT_MOUSE_BUTTON_UP: {
@@ -350,16 +359,46 @@ void Game::handleEvents() {
 			cam.x += rx * (1.0f - z0 / z1);
 			cam.y += ry * (1.0f - z0 / z1);
 			cam.zoom = z1;
+			// the world under the cursor moved, re-pick at the current position
+			motion_x = mx_i;
+			motion_y = my_i;
+			motion_pending = true;
 		}	break;
 		default:
 			break;
 		}
 	}
+	resolve_hover();
+}
+
+void Game::resolve_hover() {
+	if (!motion_pending) return;
+	motion_pending = false;
+	SDL_FPoint W = WindowToWorld(renderer, motion_x, motion_y, cam);
+	GameObject* hit = obj_container.pick_topmost(W.x, W.y);
+
+	if (hit != hovered) {
+		if (hovered) hovered->on_hover_exit(default_cursor);
+		hovered = hit;
+		if (hovered) hovered->on_hover_enter(pointer_cursor);
+	}
+	else if (hovered) {
+		hovered->on_hover();
+	}
 }
 
 
 void Game::update(double dtSeconds) {
 	//cnt++;
+	if (tex_mgr.update_hot_reload(reloaded_keys) > 0) {
+		for (const auto& key : reloaded_keys) {
+			anims.refresh_texture(key, tex_mgr); // frames first, sprites size themselves from them
+			obj_container.refresh_texture(key, tex_mgr);
+		}
+		reloaded_keys.clear();
+		redraw = true;
+	}
+	if (need_update || obj_container.animating()) redraw = true;
 	if (need_update) {
 		player_stat& active_player = *players.get_player(players.get_current_player_id());
 		Text_Button& score_text = *obj_container.get<Text_Button>("result_text");
@@ -379,60 +418,29 @@ void Game::update(double dtSeconds) {
 
 		if (current_scene == 1) { // results screen
 			std::cout << "floppa item: " << rps::floppa_item << std::endl;
-			switch (rps::floppa_item) {
-			case 0:
-				obj_container.layer_switch(11, true);
-				break;
-			case 1:
-				obj_container.layer_switch(12, true);
-				break;
-			case 2:
-				obj_container.layer_switch(13, true);
-				break;
-			default:
-				break;
+			if (rps::floppa_item >= 0 && rps::floppa_item <= 2) {
+				obj_container.layer_switch(11 + rps::floppa_item, true); // rock, paper, scissors
 			}
-			obj_container.layer_switch(4, false);
-			obj_container.layer_switch(1, true);
-			obj_container.layer_switch(2, true);
+			obj_container.apply_scene("results");
 			obj_container.get<Text_Button>("rock_text")->switch_enable(false);
 			obj_container.get<Text_Button>("paper_text")->switch_enable(false);
 			obj_container.get<Text_Button>("scissors_text")->switch_enable(false);
 		} 
 		else if (current_scene == 0) { //play screen
-			obj_container.layer_switch(0, true);
-			obj_container.layer_switch(1, false);
-			obj_container.layer_switch(2, false);
-			obj_container.layer_switch(4, false);
-			obj_container.layer_switch(5, false);
-			obj_container.layer_switch(6, false);
-			obj_container.layer_switch(11, false);
-			obj_container.layer_switch(12, false);
-			obj_container.layer_switch(13, false);
+			obj_container.apply_scene("play");
 			obj_container.get<Text_Button>("rock_text")->switch_enable(true);
 			obj_container.get<Text_Button>("paper_text")->switch_enable(true);
 			obj_container.get<Text_Button>("scissors_text")->switch_enable(true);
 		} 
 		else if (current_scene == -1) { //quit
-			obj_container.layer_switch(4, false);
-			obj_container.layer_switch(0, false);
-			obj_container.layer_switch(1, false);
-			obj_container.layer_switch(2, false);
-			obj_container.layer_switch(9, false);
+			obj_container.apply_scene("quit");
 			file_managemenet::write_data(players);
 			run = false;
 		}
 		else if (current_scene == 2) { //main menu
-			obj_container.layer_switch(4, true);
-			obj_container.layer_switch(1, false);
-			obj_container.layer_switch(2, false);
-			obj_container.layer_switch(9, true);
-			obj_container.layer_switch(5, true);
-			obj_container.layer_switch(6, true);
-			obj_container.layer_switch(10, true); //title
+			obj_container.apply_scene("main_menu"); // includes the title
 			obj_container.get<Text_Button>("player_name_text")->set_text("Logged in as: " + players.get_player(players.get_current_player_id())->name);
 		}
-		obj_container.rebuild_order();
 		need_update = false;
 		std::cout << "current results for " << active_player.name << ": wins: " << active_player.wins << " draws: " << active_player.draws << " losses: " << active_player.losses << std::endl;
 	}
@@ -451,9 +459,21 @@ void Game::render() {
 	obj_container.render_all(renderer, cam);
 
 	SDL_RenderPresent(renderer);
+	redraw = false;
 }
 
 void Game::clean() {
+	const texture_memory_stats mem = tex_mgr.memory_stats();
+	std::cout << "textures: " << (mem.used >> 10) << " KiB resident, " << mem.evictions << " evictions, " << mem.reloads << " reloads" << std::endl;
+	const render_batch_stats& draws = obj_container.render_stats();
+	std::cout << "last frame: " << draws.draw_calls << " draw calls for " << draws.quads << " quads" << std::endl;
+	const font_cache_stats fonts = tex_mgr.font_stats();
+	std::cout << "fonts: " << fonts.opens << " opened from " << fonts.file_reads << " file read(s)" << std::endl;
+	const object_pool_stats pool = object_pool::instance().stats();
+	std::cout << "objects: " << pool.allocations << " pooled allocations in " << pool.blocks << " block(s), " << pool.heap_fallbacks << " from the heap" << std::endl;
+	tex_mgr.set_text_listener(nullptr);
+	obj_container.clear(); // the scene goes before the textures its objects reference
+	anims.clear();
 	tex_mgr.clear();
 	TTF_Quit();
 	SDL_DestroyRenderer(renderer);
@@ -7,22 +7,33 @@
 #include <SDL3_image/SDL_image.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include "graphic_components/texture_manager.hpp"
+#include "graphic_components/animation.hpp"
 #include "game_obj.hpp"
 #include "graphic_components/camera.hpp"
 #include "text.hpp"
 
+// image folders the game loads, and the pre-decoded pack built from them with --pack
+inline const std::vector<std::string> asset_folders = { "assets", "assets/sprites" };
+inline const std::string asset_pack_path = "assets.pack";
+inline const std::string anim_clips_path = "data/animations.csv";
+
 class Game {
 	bool run;
 	//int cnt = 0;
 	SDL_Window* window;
 	SDL_Renderer* renderer;
 	texture_manager tex_mgr;
+	anim_library anims; // sprite clips, loaded once from anim_clips_path
 	Game_obj_container obj_container;
 	int screen_w, screen_h;
 	Camera cam;
 	float screen_scale_factor = 1.0f;
 
 	GameObject* hovered = nullptr;
+	// motion is coalesced, hover is resolved once per frame from the latest window position
+	bool motion_pending = false;
+	float motion_x = 0, motion_y = 0;
+	void resolve_hover();
 	//GameObject* held_obj = nullptr;
 	//int held_button = 0;
 	Uint64 hold_t0_ms = 0;
@@ -33,6 +44,8 @@ class Game {
 	int result;
 	player_container players;
 	int current_scene = 0;
+	std::vector<std::string> reloaded_keys; // scratch for hot reload
+	bool redraw = true; // set by input, scene changes and animating objects, cleared by render()
 public:
 	Game();
 	~Game();
@@ -43,6 +56,8 @@ public:
 	void update(double dtSeconds);
 	void render();
 	void clean();
+	bool needs_redraw() const { return redraw; }
+	void wait_for_events(Sint32 timeout_ms) { SDL_WaitEventTimeout(nullptr, timeout_ms); } // idle: sleep until input or timeout
 	SDL_Cursor* get_def_cursor() { return default_cursor; }
 	SDL_Cursor* get_pointer_cursor() { return pointer_cursor; }
 
@@ -1,39 +1,46 @@
 #include "game_obj.hpp"
 
 //BASE OBJECT
-GameObject::GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, float scale, bool show_it, int layer_in): name(name), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+GameObject::GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, float scale, bool show_it, int layer_in): name(&object_pool::instance().intern(name)), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+	texture_region region;
 	if (texture != "-") {
-		obj_tex = tex_mgr.get_texture(texture);
+		tex_ref = tex_mgr.acquire(texture);
+		region = tex_ref.region();
+		obj_tex = region.tex;
 		if (!obj_tex) {
 			std::cerr << "Texture not found for '" << texture << "'\n";
 		}
 	}
 	set_loc_position(0, 0);
 	transform.setWorld(0, 0);
-	float w = 0, h = 0;
-	if (obj_tex) SDL_GetTextureSize(obj_tex, &w, &h);
-	src_rect = { 0, 0, w, h };
+	const float w = region.src.w, h = region.src.h;
+	src_rect = region.src;
 	dst_rect = { 0, 0, w, h };
 }
 
-GameObject::GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, int x, int y, float scale, bool show_it, int layer_in) : name(name), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+GameObject::GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, int x, int y, float scale, bool show_it, int layer_in) : name(&object_pool::instance().intern(name)), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+	texture_region region;
 	if (texture != "-") {
-		obj_tex = tex_mgr.get_texture(texture);
+		tex_ref = tex_mgr.acquire(texture);
+		region = tex_ref.region();
+		obj_tex = region.tex;
 		if (!obj_tex) {
 			std::cerr << "Texture not found for '" << texture << "'\n";
 		}
 	}
 	set_loc_position(x, y);
 	transform.setWorld(x, y);
-	float w = 0, h = 0;
-	if (obj_tex) SDL_GetTextureSize(obj_tex, &w, &h);
-	src_rect = { 0, 0, w, h };
+	const float w = region.src.w, h = region.src.h;
+	src_rect = region.src;
 	dst_rect = { (float)round(transform.worldX), (float)round(transform.worldY), w, h };
 }
 
-GameObject::GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, GameObject_cluster* prn, float scale, bool show_it, int layer_in): name(name), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+GameObject::GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, GameObject_cluster* prn, float scale, bool show_it, int layer_in): name(&object_pool::instance().intern(name)), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+	texture_region region;
 	if (texture != "-") {
-		obj_tex = tex_mgr.get_texture(texture);
+		tex_ref = tex_mgr.acquire(texture);
+		region = tex_ref.region();
+		obj_tex = region.tex;
 		if (!obj_tex) {
 			std::cerr << "Texture not found for '" << texture << "'\n";
 		}
@@ -41,16 +48,18 @@ GameObject::GameObject(const std::string& name, const std::string& texture, cons
 	transform.parent = prn->get_transform();
 	set_loc_position(0, 0);
 
-	float w = 0, h = 0;
-	if (obj_tex) SDL_GetTextureSize(obj_tex, &w, &h);
+	const float w = region.src.w, h = region.src.h;
 	transform.computeWorld();
-	src_rect = { 0, 0, w, h };
+	src_rect = region.src;
 	dst_rect = { (float)round(transform.worldX), (float)round(transform.worldY), w, h };
 }
 
-GameObject::GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, int x, int y, GameObject_cluster* prn, float scale, bool show_it, int layer_in): name(name), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+GameObject::GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, int x, int y, GameObject_cluster* prn, float scale, bool show_it, int layer_in): name(&object_pool::instance().intern(name)), scale(scale), show(show_it), obj_tex(nullptr), layer(layer_in) {
+	texture_region region;
 	if (texture != "-") {
-		obj_tex = tex_mgr.get_texture(texture);
+		tex_ref = tex_mgr.acquire(texture);
+		region = tex_ref.region();
+		obj_tex = region.tex;
 		if (!obj_tex) {
 			std::cerr << "Texture not found for '" << texture << "'\n";
 		}
@@ -58,36 +67,78 @@ GameObject::GameObject(const std::string& name, const std::string& texture, cons
 	transform.parent = prn->get_transform();
 	set_loc_position(x, y);
 
-	float w = 0, h = 0;
-	if (obj_tex) SDL_GetTextureSize(obj_tex, &w, &h);
+	const float w = region.src.w, h = region.src.h;
 	transform.computeWorld();
-	src_rect = { 0, 0, w, h };
+	src_rect = region.src;
 	dst_rect = { (float)round(transform.worldX), (float)round(transform.worldY), w, h};
 }
 
-GameObject::GameObject(const GameObject& rhs) : name(rhs.name), obj_tex(rhs.obj_tex), transform(rhs.transform), src_rect(rhs.src_rect), dst_rect(rhs.dst_rect), scale(rhs.scale), show(rhs.show), layer(rhs.layer) {}
+GameObject::GameObject(const GameObject& rhs) : name(rhs.name), obj_tex(rhs.obj_tex), tex_ref(rhs.tex_ref), transform(rhs.transform), src_rect(rhs.src_rect), dst_rect(rhs.dst_rect), scale(rhs.scale), show(rhs.show), layer(rhs.layer) {}
+
+void GameObject::hierarchy_changed() {
+	if (owner) owner->invalidate_transforms();
+}
+
+void GameObject::set_region(const texture_region& r) {
+	obj_tex = r.tex;
+	src_rect = r.src;
+	dst_rect.w = r.src.w;
+	dst_rect.h = r.src.h;
+	invalidate();
+}
+
+void GameObject::set_show(bool v) {
+	if (show == v) return;
+	show = v;
+	if (owner) owner->sync_order(*this);
+	else if (host) {
+		host->wake(); // cluster bounds only enclose shown items
+		invalidate();
+	}
+}
+
+void GameObject::wake() {
+	if (owner) owner->wake(*this);
+	else if (host) host->wake();
+}
+
+void GameObject::invalidate() {
+	if (host) host->invalidate_cache();
+}
+
+void GameObject::set_layer(int l) {
+	if (layer == l) return;
+	layer = l;
+	if (owner) owner->sync_order(*this);
+}
+
+void GameObject::set_scale(float scale_in) {
+	if (scale != scale_in) invalidate();
+	scale = scale_in;
+	if (owner) owner->sync_bounds(*this);
+}
 
 void GameObject::set_dst_rect(double x, double y) {
 	dst_rect.x = static_cast<float>(std::lround(x));
 	dst_rect.y = static_cast<float>(std::lround(y));
+	if (owner) owner->sync_bounds(*this);
 }
 
 void GameObject::update(double dt, double speed) {
 	//set_loc_position(transform.localX + (speed * dt), transform.localY + (speed * dt));
+	if (transform.table) return; // solved and written back by Game_obj_container::update_transforms
 	transform.computeWorld();
 	dst_rect.x = static_cast<float>(std::lround(transform.worldX));
 	dst_rect.y = static_cast<float>(std::lround(transform.worldY));
 }
 
-void GameObject::render(SDL_Renderer* ren, const Camera& cam) const {
+void GameObject::draw(render_batch& batch, const Camera& cam) const {
 	if (!show || !obj_tex) return;
 	SDL_FRect w = dst_rect;
 	w.w *= scale;
 	w.h *= scale;
 
-	SDL_FRect r = WorldToRender(w, cam);
-
-	SDL_RenderTexture(ren, obj_tex, &src_rect, &r);
+	batch.quad(obj_tex, src_rect, WorldToRender(w, cam));
 }
 
 std::unique_ptr<GameObject> GameObject::clone() const {
@@ -102,84 +153,440 @@ SDL_Texture* GameObject::get_tex() const {
 	return obj_tex;
 }
 
+SDL_FRect GameObject::own_bounds() const {
+	return { dst_rect.x, dst_rect.y, dst_rect.w * scale, dst_rect.h * scale };
+}
+
+bool GameObject::bounds_changed() const {
+	const SDL_FRect b = own_bounds();
+	if (show != shown_seen || b.x != bounds_seen.x || b.y != bounds_seen.y || b.w != bounds_seen.w || b.h != bounds_seen.h) return true;
+	if (auto* c = dynamic_cast<const GameObject_cluster*>(this)) {
+		for (const auto& item : c->get_items()) {
+			if (item->bounds_changed()) return true;
+		}
+	}
+	return false;
+}
+
+void GameObject::mark_bounds_seen() {
+	bounds_seen = own_bounds();
+	shown_seen = show;
+	if (auto* c = dynamic_cast<GameObject_cluster*>(this)) {
+		for (const auto& item : c->get_items()) item->mark_bounds_seen();
+	}
+}
+
 bool GameObject::hit_test(float wx, float wy) const {
 	SDL_FRect b = dst_rect; b.w *= scale; b.h *= scale;
 	return (wx >= b.x && wx < b.x + b.w && wy >= b.y && wy < b.y + b.h);
 }
 
+void GameObject::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	if (!tex_ref || tex_ref.name() != key) return;
+	set_region(tex_mgr.get_region(key));
+}
+
 
 //CONTAINER
 
-void Game_obj_container::rebuild_order() const {
-	render_order_.clear();
-	render_order_.reserve(objects.size());
-	for (auto& [_, up] : objects) {
-		if (up->does_show()) render_order_.push_back(up.get());
+// same name again replaces the object, its old handle goes stale
+obj_handle Game_obj_container::insert(const std::string& name, std::unique_ptr<GameObject> obj) {
+	obj->owner = this;
+	transforms_stale = true;
+	obj->order_seq = next_seq++;
+	sync_order(*obj);
+	wake(*obj); // everything gets one update, static objects fall asleep after it
+	if (auto it = names.find(name); it != names.end()) {
+		slot& s = slots[it->second.index];
+		bucket_erase(*objects[s.dense]);
+		drop_active(*objects[s.dense]);
+		objects[s.dense] = std::move(obj);
+		++s.generation;
+		it->second.generation = s.generation;
+		return it->second;
+	}
+
+	Uint32 index;
+	if (!free_slots.empty()) {
+		index = free_slots.back();
+		free_slots.pop_back();
+	}
+	else {
+		index = static_cast<Uint32>(slots.size());
+		slots.emplace_back();
+	}
+	slots[index].dense = static_cast<Uint32>(objects.size());
+	objects.push_back(std::move(obj));
+	dense_slot.push_back(index);
+
+	const obj_handle h{ index, slots[index].generation };
+	names.emplace(name, h);
+	return h;
+}
+
+void Game_obj_container::clear() {
+	layer_buckets.clear();
+	grid.clear();
+	grid_large.clear();
+	active.clear();
+	names.clear();
+	slots.clear();
+	free_slots.clear();
+	dense_slot.clear();
+	transform_objs.assign(1, nullptr);
+	unbound_objs.clear();
+	text_watchers.clear();
+	transforms.clear();
+	objects.clear();
+	updating.clear();
+	transforms_stale = true;
+	object_pool::instance().trim();
+}
+
+void Game_obj_container::invalidate_caches() {
+	for (auto& up : objects) {
+		if (auto* c = dynamic_cast<GameObject_cluster*>(up.get())) c->invalidate_cache();
+	}
+}
+
+bool Game_obj_container::remove(obj_handle h) {
+	GameObject* obj = lookup(h);
+	if (!obj) return false;
+	names.erase(obj->get_name());
+	bucket_erase(*obj);
+	drop_active(*obj);
+	transforms_stale = true;
+
+	const Uint32 hole = slots[h.index].dense;
+	const Uint32 last = static_cast<Uint32>(objects.size()) - 1;
+	if (hole != last) {
+		objects[hole] = std::move(objects[last]);
+		dense_slot[hole] = dense_slot[last];
+		slots[dense_slot[hole]].dense = hole;
 	}
-	std::stable_sort(render_order_.begin(), render_order_.end(),
-		[](const GameObject* a, const GameObject* b) {
-			if (a->get_layer() != b->get_layer())
-				return a->get_layer() < b->get_layer();
-			return std::less<const GameObject*>{}(a, b);
-		});
+	objects.pop_back();
+	dense_slot.pop_back();
+
+	++slots[h.index].generation;
+	free_slots.push_back(h.index);
+	return true;
+}
+
+void Game_obj_container::bucket_insert(GameObject& obj) {
+	auto& bucket = layer_buckets[obj.layer];
+	auto pos = std::lower_bound(bucket.begin(), bucket.end(), obj.order_seq,
+		[](const GameObject* o, Uint32 seq) { return o->order_seq < seq; });
+	bucket.insert(pos, &obj);
+	obj.bucket_layer = obj.layer;
+	obj.in_bucket = true;
+	grid_insert(obj);
+}
+
+void Game_obj_container::bucket_erase(GameObject& obj) {
+	if (!obj.in_bucket) return;
+	auto& bucket = layer_buckets[obj.bucket_layer];
+	auto pos = std::lower_bound(bucket.begin(), bucket.end(), obj.order_seq,
+		[](const GameObject* o, Uint32 seq) { return o->order_seq < seq; });
+	if (pos != bucket.end() && *pos == &obj) bucket.erase(pos);
+	obj.in_bucket = false;
+	grid_erase(obj);
 }
 
-void Game_obj_container::set_layer(GameObject& obj, int new_layer) {
-	if (obj.get_layer() != new_layer) {
-		obj.set_layer(new_layer);
-		order_dirty = true;
+namespace {
+	inline Uint64 cell_key(int cx, int cy) {
+		return (static_cast<Uint64>(static_cast<Uint32>(cx)) << 32) | static_cast<Uint32>(cy);
+	}
+}
+
+SDL_Rect Game_obj_container::grid_span_of(const GameObject& obj) {
+	const SDL_FRect& d = obj.dst_rect;
+	const float w = d.w * obj.scale, h = d.h * obj.scale;
+	return {
+		static_cast<int>(std::floor(d.x / grid_cell)), static_cast<int>(std::floor(d.y / grid_cell)),
+		static_cast<int>(std::floor((d.x + w) / grid_cell)), static_cast<int>(std::floor((d.y + h) / grid_cell))
+	};
+}
+
+void Game_obj_container::grid_insert(GameObject& obj) {
+	const SDL_Rect span = grid_span_of(obj);
+	obj.grid_span = span;
+	obj.grid_large = (span.w - span.x + 1) * (span.h - span.y + 1) > grid_max_cells;
+	if (obj.grid_large) {
+		grid_large.push_back(&obj);
+		return;
+	}
+	for (int cy = span.y; cy <= span.h; ++cy) {
+		for (int cx = span.x; cx <= span.w; ++cx) {
+			grid[cell_key(cx, cy)].push_back(&obj);
+		}
+	}
+}
+
+void Game_obj_container::grid_erase(GameObject& obj) {
+	auto drop = [&](std::vector<GameObject*>& v) {
+		auto it = std::find(v.begin(), v.end(), &obj);
+		if (it == v.end()) return;
+		*it = v.back(); // order inside a cell doesn't matter, picking compares layer and spawn order
+		v.pop_back();
+	};
+	const SDL_Rect span = obj.grid_span;
+	if (obj.grid_large) drop(grid_large);
+	else {
+		for (int cy = span.y; cy <= span.h; ++cy) {
+			for (int cx = span.x; cx <= span.w; ++cx) {
+				if (auto it = grid.find(cell_key(cx, cy)); it != grid.end()) drop(it->second);
+			}
+		}
+	}
+	obj.grid_span = { 0, 0, -1, -1 };
+	obj.grid_large = false;
+}
+
+void Game_obj_container::sync_bounds(GameObject& obj) {
+	if (obj.bounds_changed()) bounds_stale = true;
+	if (!obj.in_bucket) return;
+	const SDL_Rect span = grid_span_of(obj);
+	const SDL_Rect& old = obj.grid_span;
+	if (span.x == old.x && span.y == old.y && span.w == old.w && span.h == old.h) return; // same cells, nothing to move
+	grid_erase(obj);
+	grid_insert(obj);
+}
+
+void Game_obj_container::wake(GameObject& obj) {
+	if (obj.awake) return;
+	obj.awake = true;
+	active.push_back(&obj);
+}
+
+void Game_obj_container::wake_text(const std::string& text) {
+	if (transforms_stale) rebuild_transforms(); // watchers are refilled with the table, stale ones may be gone
+	auto it = text_watchers.find(text);
+	if (it == text_watchers.end()) return;
+	for (GameObject* o : it->second) o->wake(); // cluster items wake their cluster
+}
+
+void Game_obj_container::drop_active(GameObject& obj) {
+	if (!obj.awake) return;
+	obj.awake = false;
+	auto it = std::find(active.begin(), active.end(), &obj);
+	if (it != active.end()) active.erase(it);
+}
+
+void Game_obj_container::sync_order(GameObject& obj) {
+	bounds_stale = true;
+	const bool want = obj.does_show();
+	if (obj.in_bucket && (!want || obj.bucket_layer != obj.layer)) bucket_erase(obj);
+	if (want && !obj.in_bucket) bucket_insert(obj);
+}
+
+void Game_obj_container::rebuild_order() {
+	layer_buckets.clear();
+	grid.clear();
+	grid_large.clear();
+	for (auto& up : objects) {
+		up->in_bucket = false;
+		up->grid_span = { 0, 0, -1, -1 };
+		up->grid_large = false;
+		if (up->does_show()) bucket_insert(*up);
 	}
 }
 
 void Game_obj_container::update_all(double dtSeconds, double speed) {
-	for (auto& [_, obj] : objects) {
-		obj->update(dtSeconds, speed);
+	// objects woken while this runs land in the fresh active list
+	updating.swap(active);
+	active.clear();
+	for (GameObject* o : updating) o->awake = false;
+	for (GameObject* o : updating) {
+		o->update(dtSeconds, speed);
+		sync_bounds(*o);
+		if (o->is_dynamic() || !o->transform.table) wake(*o); // unbound objects still position themselves in update()
 	}
+	updating.clear();
+	update_transforms();
+	if (bounds_stale) update_bounds();
 }
 
-void Game_obj_container::render_all(SDL_Renderer* ren, const Camera& cam) const {
-	if (order_dirty) {
-		rebuild_order();
-		order_dirty = false;
+namespace {
+	void grow(SDL_FRect& a, const SDL_FRect& b) {
+		const float x0 = std::min(a.x, b.x), y0 = std::min(a.y, b.y);
+		const float x1 = std::max(a.x + a.w, b.x + b.w), y1 = std::max(a.y + a.h, b.y + b.h);
+		a = { x0, y0, x1 - x0, y1 - y0 };
 	}
+
+	// fallback for objects outside the transform table
+	void subtree_bounds(GameObject& o, SDL_FRect& out) {
+		out = o.own_bounds();
+		if (auto* c = dynamic_cast<GameObject_cluster*>(&o)) {
+			for (const auto& item : c->get_items()) {
+				if (!item->does_show()) continue;
+				SDL_FRect b;
+				subtree_bounds(*item, b);
+				grow(out, b);
+			}
+		}
+	}
+}
+
+// own bounds forward, then children fold into their parents backwards; parent-before-child order makes both linear
+void Game_obj_container::update_bounds() {
+	const size_t n = transform_objs.size();
+	for (size_t i = 1; i < n; ++i) transform_objs[i]->bounds = transform_objs[i]->own_bounds();
+	for (size_t i = n - 1; i > 0; --i) {
+		const int p = transforms.parent_of(i);
+		if (p > 0 && transform_objs[i]->does_show()) grow(transform_objs[p]->bounds, transform_objs[i]->bounds);
+	}
+	for (GameObject* o : unbound_objs) subtree_bounds(*o, o->bounds);
+	for (auto& up : objects) up->mark_bounds_seen();
+	bounds_stale = false;
+}
+// lays every object and cluster item out depth first, so each parent lands before its children
+void Game_obj_container::rebuild_transforms() {
+	transforms.clear();
+	transform_objs.assign(1, nullptr);
+	text_watchers.clear();
+	std::unordered_map<const Transform*, int> node_of;
+	std::vector<std::pair<GameObject*, int>> stack;
+
+	auto bind = [&](GameObject* root, int parent_node) {
+		stack.emplace_back(root, parent_node);
+		while (!stack.empty()) {
+			auto [o, pn] = stack.back();
+			stack.pop_back();
+			Transform& t = o->transform;
+			t.table = &transforms;
+			t.node = transforms.add(pn, t.localX, t.localY);
+			node_of[&t] = t.node;
+			transform_objs.push_back(o);
+			if (auto* c = dynamic_cast<GameObject_cluster*>(o)) {
+				const auto& items = c->get_items();
+				for (auto it = items.rbegin(); it != items.rend(); ++it) stack.emplace_back(it->get(), t.node);
+			}
+		}
+	};
+
+	// roots first, then objects parented to something already laid out; anything left keeps its own computeWorld
+	std::vector<GameObject*> pending;
+	for (auto& up : objects) {
+		if (up->transform.parent) pending.push_back(up.get());
+		else bind(up.get(), 0);
+	}
+	for (bool progress = true; progress && !pending.empty();) {
+		progress = false;
+		for (size_t i = 0; i < pending.size();) {
+			auto it = node_of.find(pending[i]->transform.parent);
+			if (it == node_of.end()) { ++i; continue; }
+			bind(pending[i], it->second);
+			pending[i] = pending.back();
+			pending.pop_back();
+			progress = true;
+		}
+	}
+	for (GameObject* o : pending) o->transform.table = nullptr;
+	unbound_objs = std::move(pending);
+
+	// every object and cluster item, unbound ones included
+	std::vector<GameObject*> walk;
+	for (auto& up : objects) walk.push_back(up.get());
+	while (!walk.empty()) {
+		GameObject* o = walk.back();
+		walk.pop_back();
+		if (const std::string* t = o->watched_text()) text_watchers[*t].push_back(o);
+		if (auto* c = dynamic_cast<GameObject_cluster*>(o)) {
+			for (const auto& item : c->get_items()) walk.push_back(item.get());
+		}
+	}
+	transforms_stale = false;
+}
+
+// one linear pass over the dirty range, then world positions and dst_rect go back to the objects that moved
+void Game_obj_container::update_transforms() {
+	if (transforms_stale) rebuild_transforms();
+	transforms.update();
+	for (size_t i = transforms.dirty_begin(); i < transforms.size(); ++i) {
+		if (!transforms.changed(i)) continue;
+		GameObject& o = *transform_objs[i];
+		o.transform.worldX = transforms.world_x(i);
+		o.transform.worldY = transforms.world_y(i);
+		o.transform.dirty = false;
+		o.dst_rect.x = static_cast<float>(std::lround(o.transform.worldX));
+		o.dst_rect.y = static_cast<float>(std::lround(o.transform.worldY));
+		sync_bounds(o); // only top level objects are in the pick grid
+		if (o.host && transforms.moved_locally(i)) o.invalidate(); // moved inside its cluster, even if the cluster moved too
+		bounds_stale = true;
+	}
+	transforms.clear_changed();
+}
+
+void Game_obj_container::render_all(SDL_Renderer* ren, const Camera& cam) const {
 	SDL_SetRenderScale(ren, cam.zoom, cam.zoom);
 
 	int outW = 0, outH = 0;
 	SDL_GetCurrentRenderOutputSize(ren, &outW, &outH);
 	SDL_FRect worldView = { cam.x, cam.y, outW / cam.zoom, outH / cam.zoom };
 
-	auto intersects = [](const SDL_FRect& a, const SDL_FRect& b) {
-		return !(a.x > b.x + b.w || a.x + a.w < b.x || a.y > b.y + b.h || a.y + a.h < b.y);
-		};
-
-	for (const GameObject* o : render_order_) {
-		if (intersects(o->get_dst_rect(), worldView)) {
-			o->render(ren, cam);
+	batch.begin(ren);
+	batch.set_view(worldView); // clusters cull their items against it too
+	for (const auto& [layer, bucket] : layer_buckets) {
+		if (!layer_visible(layer)) continue;
+		for (const GameObject* o : bucket) {
+			if (batch.visible(o->get_bounds())) {
+				o->draw(batch, cam);
+			}
 		}
 	}
+	batch.end();
+}
+
+bool Game_obj_container::animating() const {
+	for (const GameObject* o : active) { // animating objects are dynamic, so they never sleep
+		if (o->in_bucket && layer_visible(o->bucket_layer) && o->animating()) return true;
+	}
+	return false;
 }
 
 void Game_obj_container::set_scale_all(float new_scale) {
-	for (auto& [_, obj] : objects) {
+	for (auto& obj : objects) {
 		obj->set_scale(new_scale);
 	}
 }
 
 void Game_obj_container::layer_switch(int layer, bool enabled) {
-	for (auto& [_, obj] : objects) {
-		if (obj->get_layer() == layer) {
-			obj->set_show(enabled);
-		}
+	if (enabled) layer_mask |= layer_bit(layer);
+	else layer_mask &= ~layer_bit(layer);
+}
+
+bool Game_obj_container::apply_scene(std::string_view name) {
+	auto it = scenes.find(name);
+	if (it == scenes.end()) {
+		std::cerr << "Unknown scene preset '" << name << "'\n";
+		return false;
+	}
+	layer_mask = (layer_mask & ~it->second.hide) | it->second.show;
+	return true;
+}
+
+void Game_obj_container::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	for (auto& obj : objects) {
+		obj->refresh_texture(key, tex_mgr);
 	}
 }
 
 GameObject* Game_obj_container::pick_topmost(float wx, float wy) const {
-	if (order_dirty) { rebuild_order(); order_dirty = false; }
-	for (auto it = render_order_.rbegin(); it != render_order_.rend(); ++it) {
-		GameObject* o = *it;
-		if (o->does_show() && o->hit_test(wx, wy)) return o;
+	GameObject* best = nullptr;
+	auto consider = [&](GameObject* o) {
+		if (!layer_visible(o->bucket_layer)) return;
+		if (best && (o->bucket_layer < best->bucket_layer ||
+			(o->bucket_layer == best->bucket_layer && o->order_seq < best->order_seq))) return; // drawn below the current hit
+		if (o->hit_test(wx, wy)) best = o;
+	};
+
+	const int cx = static_cast<int>(std::floor(wx / grid_cell));
+	const int cy = static_cast<int>(std::floor(wy / grid_cell));
+	if (auto it = grid.find(cell_key(cx, cy)); it != grid.end()) {
+		for (GameObject* o : it->second) consider(o);
 	}
-	return nullptr;
+	for (GameObject* o : grid_large) consider(o);
+	return best;
 }
 
 //OBJECT CLUSTER
@@ -188,9 +595,11 @@ void GameObject_cluster::add_item_local(const GameObject& obj_in, int lx, int ly
 	auto p = obj_in.clone();
 	p->get_transform()->parent = get_transform();
 	p->get_transform()->setLocal((float)lx, (float)ly);
+	p->host = this;
 	p->set_show(show_in_clust);
 	items.push_back(std::move(p));
 	get_transform()->markDirty();
+	hierarchy_changed();
 }
 
 void GameObject_cluster::add_item_world(const GameObject& obj_in, bool show_in_clust) {
@@ -200,12 +609,13 @@ void GameObject_cluster::add_item_world(const GameObject& obj_in, bool show_in_c
 	double lx = obj_in.get_transform()->worldX - this->get_transform()->worldX;
 	double ly = obj_in.get_transform()->worldY - this->get_transform()->worldY;
 	p->get_transform()->setLocal(lx, ly);
+	p->host = this;
 	p->set_show(show_in_clust);
 	items.push_back(std::move(p));
+	hierarchy_changed();
 }
 
 void GameObject_cluster::update(double dt, double speed) {
-	get_transform()->computeWorld();
 	GameObject::update(0, 0);
 
 	for (auto& c : items) {
@@ -213,18 +623,107 @@ void GameObject_cluster::update(double dt, double speed) {
 	}
 }
 
-void GameObject_cluster::render(SDL_Renderer* ren, const Camera& cam) const {
-	//render self
+bool GameObject_cluster::is_dynamic() const {
+	for (const auto& c : items) {
+		if (c->is_dynamic()) return true;
+	}
+	return false;
+}
+
+bool GameObject_cluster::animating() const {
+	for (const auto& c : items) {
+		if (c->does_show() && c->animating()) return true;
+	}
+	return false;
+}
+
+GameObject_cluster::~GameObject_cluster() {
+	if (cache_tex) SDL_DestroyTexture(cache_tex);
+}
+
+void GameObject_cluster::set_cached(bool enabled) {
+	cached = enabled;
+	cache_dirty = true;
+	if (!enabled && cache_tex) {
+		SDL_DestroyTexture(cache_tex);
+		cache_tex = nullptr;
+	}
+}
+
+void GameObject_cluster::invalidate_cache() {
+	cache_dirty = true;
+	invalidate(); // a cached cluster inside another one
+}
+
+// draws self + items into cache_tex with the bounds' corner as origin, 1 texel per world unit
+bool GameObject_cluster::redraw_cache(SDL_Renderer* ren) const {
+	const SDL_FRect& b = get_bounds();
+	const int w = static_cast<int>(std::ceil(b.w)), h = static_cast<int>(std::ceil(b.h));
+	if (w <= 0 || h <= 0) return false;
+	if (cache_tex && (cache_tex->w != w || cache_tex->h != h)) {
+		SDL_DestroyTexture(cache_tex);
+		cache_tex = nullptr;
+	}
+	if (!cache_tex) {
+		cache_tex = SDL_CreateTexture(ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+		if (!cache_tex) {
+			SDL_Log("[SDL] cluster cache texture failed: %s", SDL_GetError());
+			return false;
+		}
+		SDL_SetTextureBlendMode(cache_tex, SDL_BLENDMODE_BLEND_PREMULTIPLIED); // blending into clear texels leaves colour premultiplied
+	}
+
+	SDL_Texture* prev_target = SDL_GetRenderTarget(ren);
+	float sx = 1.f, sy = 1.f;
+	SDL_GetRenderScale(ren, &sx, &sy);
+	SDL_SetRenderTarget(ren, cache_tex);
+	SDL_SetRenderScale(ren, 1.f, 1.f);
+	SDL_SetRenderDrawColor(ren, 0, 0, 0, 0);
+	SDL_RenderClear(ren);
+
+	render_batch local;
+	local.begin(ren);
+	draw_direct(local, Camera{ b.x, b.y, 1.f });
+	local.end();
+
+	SDL_SetRenderTarget(ren, prev_target);
+	SDL_SetRenderScale(ren, sx, sy);
+	cache_dirty = false;
+	return true;
+}
+
+void GameObject_cluster::draw(render_batch& batch, const Camera& cam) const {
 	if (!does_show()) return;
-	GameObject::render(ren, cam);
-	if (SDL_GetError()[0] != '\0') {
-		SDL_Log("[SDL] RenderCopy (cluster) error: %s", SDL_GetError());
-		SDL_ClearError();
+	if (!cached || !batch.renderer()) {
+		draw_direct(batch, cam);
+		return;
+	}
+	if (cache_dirty || !cache_tex) {
+		batch.flush(); // queued quads belong to the current target
+		if (!redraw_cache(batch.renderer())) {
+			draw_direct(batch, cam);
+			return;
+		}
 	}
+	const float w = static_cast<float>(cache_tex->w), h = static_cast<float>(cache_tex->h);
+	const SDL_FRect& b = get_bounds();
+	batch.quad(cache_tex, { 0, 0, w, h }, WorldToRender({ b.x, b.y, w, h }, cam));
+}
+
+void GameObject_cluster::draw_direct(render_batch& batch, const Camera& cam) const {
+	//render self
+	GameObject::draw(batch, cam);
 
-	//render owned
+	//render owned, each item culled on its own
 	for (auto& c : items) {
-		c->render(ren, cam);
+		if (batch.visible(c->get_bounds())) c->draw(batch, cam);
+	}
+}
+
+void GameObject_cluster::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	GameObject::refresh_texture(key, tex_mgr);
+	for (auto& c : items) {
+		c->refresh_texture(key, tex_mgr);
 	}
 }
 
@@ -244,24 +743,37 @@ void Button::on_hover_exit(SDL_Cursor* default_cursor) {
 
 // TEXT BUTTONS
 
+namespace {
+	SDL_Color hover_tint(SDL_Color c) {
+		if (c.r != 0) c.r -= std::clamp(round(c.r * 0.25), -60.0, 60.0);
+		if (c.g != 0) c.g -= std::clamp(round(c.g * 0.25), -60.0, 60.0);
+		if (c.b != 0) c.b -= std::clamp(round(c.b * 0.25), -60.0, 60.0);
+		return c;
+	}
+}
+
 Text_Button::Text_Button(const std::string& name, const std::string& texture, texture_manager& tex_mgr_in, float scale, bool show_it, int layer_in, int variable)
-	: Button(name, texture, tex_mgr_in, scale, show_it, layer_in), tex_mgr(tex_mgr_in), default_bg_color(tex_mgr.get_bg_color(name)) {
+	: Button(name, texture, tex_mgr_in, scale, show_it, layer_in), tex_mgr(tex_mgr_in) {
 	var = variable;
+	attach_text();
 }
 
 Text_Button::Text_Button(const std::string& name, const std::string& texture, texture_manager& tex_mgr_in, int x, int y, float scale, bool show_it, int layer_in, int variable)
-	: Button(name, texture, tex_mgr_in, x, y, scale, show_it, layer_in), tex_mgr(tex_mgr_in), default_bg_color(tex_mgr.get_bg_color(name)) {
+	: Button(name, texture, tex_mgr_in, x, y, scale, show_it, layer_in), tex_mgr(tex_mgr_in) {
 	var = variable;
+	attach_text();
 }
 
 Text_Button::Text_Button(const std::string& name, const std::string& texture, texture_manager& tex_mgr_in, GameObject_cluster* prn, float scale, bool show_it, int layer_in, int variable)
-	: Button(name, texture, tex_mgr_in, prn, scale, show_it, layer_in), tex_mgr(tex_mgr_in), default_bg_color(tex_mgr.get_bg_color(name)) {
+	: Button(name, texture, tex_mgr_in, prn, scale, show_it, layer_in), tex_mgr(tex_mgr_in) {
 	var = variable;
+	attach_text();
 }
 
 Text_Button::Text_Button(const std::string& name, const std::string& texture, texture_manager& tex_mgr_in, int x, int y, GameObject_cluster* prn, float scale, bool show_it, int layer_in, int variable)
-	: Button(name, texture, tex_mgr_in, x, y, prn, scale, show_it, layer_in), tex_mgr(tex_mgr_in), default_bg_color(tex_mgr.get_bg_color(name)) {
+	: Button(name, texture, tex_mgr_in, x, y, prn, scale, show_it, layer_in), tex_mgr(tex_mgr_in) {
 	var = variable;
+	attach_text();
 }
 
 int Text_Button::action() {
@@ -273,51 +785,81 @@ int Text_Button::action() {
 	return var;
 }
 
+// switches the text entry to layered so background/border/hover never touch the rasterizer
+void Text_Button::attach_text() {
+	text = tex_mgr.get_text_entry(get_name());
+	if (!text) return;
+	if (!text->glyph_mode) {
+		tex_mgr.set_text_layered(get_name(), true);
+		set_region(tex_mgr.get_region(get_name()));
+	}
+	sync_text_size();
+}
+
+void Text_Button::sync_text_size() {
+	text_generation = text->generation;
+	invalidate();
+	const float inner_w = text->glyph_mode ? text->run.w : get_src_rect().w;
+	const float inner_h = text->glyph_mode ? text->run.h : get_src_rect().h;
+	const int bw = text->border_enabled ? text->border_thickness : 0;
+	auto& d = get_dst_rect();
+	d.w = inner_w + 2.0f * (text->pad_x + bw);
+	d.h = inner_h + 2.0f * (text->pad_y + bw);
+}
+
 void Text_Button::update(double dt, double speed) {
 	GameObject::update(0.0, 0.0);
+	if (!text || text->generation == text_generation) return; // nothing rebuilt, no lookup needed
 
-	SDL_Texture* latest = tex_mgr.get_texture(get_name());
-	if (latest != get_tex()) {
-		set_texture(latest);
+	if (!text->glyph_mode) {
+		texture_region latest = tex_mgr.get_region(get_name());
+		if (latest.tex) set_region(latest);
+	}
+	sync_text_size();
+}
 
-		float w = 0, h = 0;
-		if (latest) {
-			SDL_GetTextureSize(latest, &w, &h);
-		}
-		else {
-			w = h = 0;
-		}
+void Text_Button::draw(render_batch& batch, const Camera& cam) const {
+	if (!text) {
+		GameObject::draw(batch, cam);
+		return;
+	}
+	if (!does_show()) return;
+	const SDL_FRect& d = get_dst_rect();
+	const float s = get_scale();
+	const SDL_FRect outer{ d.x - cam.x, d.y - cam.y, d.w * s, d.h * s };
+	const float bw = (text->border_enabled ? text->border_thickness : 0) * s;
+
+	if (text->bg_enabled && text->bg_color.a > 0) {
+		const SDL_FRect bg{ outer.x + bw, outer.y + bw, outer.w - 2 * bw, outer.h - 2 * bw };
+		batch.fill(bg, hover ? hover_tint(text->bg_color) : text->bg_color);
+	}
+	if (bw > 0 && text->border_color.a > 0) {
+		const SDL_Color c = text->border_color;
+		const SDL_FRect edges[4] = {
+			{ outer.x, outer.y, outer.w, bw },
+			{ outer.x, outer.y + outer.h - bw, outer.w, bw },
+			{ outer.x, outer.y + bw, bw, outer.h - 2 * bw },
+			{ outer.x + outer.w - bw, outer.y + bw, bw, outer.h - 2 * bw },
+		};
+		batch.fill(edges, 4, c);
+	}
 
-		get_src_rect() = { 0, 0, w, h };
-		auto& d = get_dst_rect();
-		d.w = w;
-		d.h = h;
+	const float tx = outer.x + bw + text->pad_x * s;
+	const float ty = outer.y + bw + text->pad_y * s;
+	if (text->glyph_mode) {
+		batch.geometry(text->run.tex, text->run.verts, text->run.indices, tx, ty, s);
+	}
+	else if (get_tex()) {
+		const SDL_FRect& src = get_src_rect();
+		batch.quad(get_tex(), src, { tx, ty, src.w * s, src.h * s });
 	}
 }
 
+// hover only flips a flag, render picks the tinted background color
 void Text_Button::on_hover_enter(SDL_Cursor* pointer_cursor) {
 	if (!hover) {
 		hover = true;
 		SDL_SetCursor(pointer_cursor);
-		SDL_Color new_color = tex_mgr.get_bg_color(get_name());
-		if (new_color.r != 0) {
-			new_color.r -= std::clamp(round(new_color.r * 0.25), -60.0, 60.0);
-		}
-		if (new_color.g != 0) {
-			new_color.g -= std::clamp(round(new_color.g * 0.25), -60.0, 60.0);
-		}
-		if (new_color.b != 0) {
-			new_color.b -= std::clamp(round(new_color.b * 0.25), -60.0, 60.0);
-		}
-
-		if (tex_mgr.set_text_background_const_padding(get_name(), true, new_color)) {
-			if (auto* t = tex_mgr.get_texture(get_name())) {
-				set_texture(t);
-				float w = 0, h = 0; SDL_GetTextureSize(t, &w, &h);
-				get_src_rect() = { 0,0,w,h };
-				auto& d = get_dst_rect(); d.w = w; d.h = h;
-			}
-		}
 	}
 }
 
@@ -325,43 +867,33 @@ void Text_Button::on_hover_exit(SDL_Cursor* default_cursor) {
 	if (hover) {
 		hover = false;
 		SDL_SetCursor(default_cursor);
-
-		if (tex_mgr.set_text_background_const_padding(get_name(), true, default_bg_color)) {
-			if (auto* t = tex_mgr.get_texture(get_name())) {
-				set_texture(t);
-				float w = 0, h = 0; SDL_GetTextureSize(t, &w, &h);
-				get_src_rect() = { 0,0,w,h };
-				auto& d = get_dst_rect(); d.w = w; d.h = h;
-			}
-		}
 	}
 }
 
 void Text_Button::set_text(const std::string& new_text) {
 	if (tex_mgr.set_text_string(get_name(), new_text)) {
-		if (auto* t = tex_mgr.get_texture(get_name())) {
-			set_texture(t);
-			float w = 0, h = 0; SDL_GetTextureSize(t, &w, &h);
-			get_src_rect() = { 0,0,w,h };
-			auto& d = get_dst_rect(); d.w = w; d.h = h;
+		if (!text || !text->glyph_mode) {
+			texture_region r = tex_mgr.get_region(get_name());
+			if (r.tex) set_region(r);
 		}
+		if (text) sync_text_size();
 	}
 }
 
 void Text_Button::set_background(bool enabled, SDL_Color color) {
 	if (tex_mgr.set_text_background_const_padding(get_name(), true, color)) {
-		if (auto* t = tex_mgr.get_texture(get_name())) {
-			set_texture(t);
-			float w = 0, h = 0; SDL_GetTextureSize(t, &w, &h);
-			get_src_rect() = { 0,0,w,h };
-			auto& d = get_dst_rect(); d.w = w; d.h = h;
+		if (text) {
+			sync_text_size();
+			return;
 		}
+		texture_region r = tex_mgr.get_region(get_name());
+		if (r.tex) set_region(r);
 	}
 }
 
 //sprite objs
 
-void streched_bg_obj::set_texture(const std::string& texture, const texture_manager& tex_mgr) {
+void streched_bg_obj::set_texture(const std::string& texture, texture_manager& tex_mgr) {
 	image.set_tex(texture, tex_mgr);
 }
 
@@ -369,7 +901,7 @@ void streched_bg_obj::set_screen(int screen_w, int screen_h) {
 	image.set_screen(screen_w, screen_h);
 }
 
-void streched_bg_obj::init(const std::string& texture, const texture_manager& tex_mgr, int screen_w, int screen_h) {
+void streched_bg_obj::init(const std::string& texture, texture_manager& tex_mgr, int screen_w, int screen_h) {
 	image.set_tex(texture, tex_mgr);
 	image.set_screen(screen_w, screen_h);
 }
@@ -378,113 +910,113 @@ void streched_bg_obj::update(double dt, double speed) {
 	GameObject::update(0.0, 0.0);
 }
 
-void streched_bg_obj::render(SDL_Renderer* ren, const Camera& cam) const {
+void streched_bg_obj::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	GameObject::refresh_texture(key, tex_mgr);
+	image.refresh_texture(key, tex_mgr);
+}
+
+SDL_FRect streched_bg_obj::own_bounds() const {
+	return { -1e30f, -1e30f, 2e30f, 2e30f };
+}
+
+void streched_bg_obj::draw(render_batch& batch, const Camera& cam) const {
 	if (does_show()) {
-		image.render(ren, cam);
+		image.draw(batch);
 	}
 }
 
 //sprite ------------------------------------------------------------
 
-void sprite::add_element(const std::string& texture, const texture_manager& tex_mgr) {
-	if (elements.size() < 1) {
-		float w, h;
-		auto adding_Tex = tex_mgr.get_texture(texture);
-		SDL_GetTextureSize(adding_Tex, &w, &h);
-		get_src_rect() = { 0, 0, w, h };
-		get_dst_rect() = { (float)round(get_transform()->worldX), (float)round(get_transform()->worldY), w, h };
+void sprite::set_clip(const anim_library& lib, clip_id id) {
+	anims = &lib;
+	cursor = anim_cursor{};
+	cursor.clip = id;
+	set_state(state); // playing / direction follow the state
+	if (const anim_frame* first = lib.frame(cursor)) {
+		get_src_rect() = first->src;
+		get_dst_rect().w = first->src.w;
+		get_dst_rect().h = first->src.h;
 	}
-
-	auto p = std::make_unique<sprite_component>(texture, tex_mgr);
-	elements.push_back(std::move(p));
+	invalidate();
 }
 
-//void sprite::add_elements_batch(const std::string& name) {}
-
-std::unique_ptr<sprite_component>& sprite::get_element(size_t idx) {
-	return elements.at(idx);
+void sprite::set_state(int new_State) {
+	state = new_State;
+	cursor.dir = state < 0 ? -1 : 1;
+	cursor.playing = (state == 1 || state == -1 || state == 4 || state == -4);
+	wake();
 }
 
 void sprite::set_current_idx(int idx) {
-	if (idx < 0) idx = static_cast<int>(elements.size()) - 1;
-	if (idx >= static_cast<int>(elements.size())) idx = 0;
-	current_element = idx;
+	const anim_clip* clip = anims ? anims->get(cursor.clip) : nullptr;
+	if (!clip || clip->frames.empty()) return;
+	const int n = static_cast<int>(clip->frames.size());
+	if (idx < 0) idx = n - 1;
+	if (idx >= n) idx = 0;
+	if (static_cast<Uint32>(idx) != cursor.frame) invalidate();
+	cursor.frame = static_cast<Uint32>(idx);
+	cursor.t = 0;
+}
+
+bool sprite::animating() const {
+	switch (state) {
+	case 1: case -1: return cursor.playing; // timed playback, a once clip ends by itself
+	case 2: case -2: return active;         // one pending step
+	case 4: case -4: return hover && cursor.playing; // plays while hovered
+	default: return false;
+	}
 }
- 
 
+// timing and frame order come from the clip, the state only says when to play
 void sprite::update(double dt, double speed) {
-	switch (state){
-		case 0:
-			GameObject::update(0.0, 0.0);
-			break;
-		case 1:
-			t = t + dt;
-			if (t >= tick_time) {
-				set_current_idx(++current_element);
-				GameObject::update(0.0, 0.0);
-				t = 0;
-			}
-			break;
-		case -1:
-			t = t + dt;
-			if (t >= tick_time) {
-				set_current_idx(current_element - 1);
-				GameObject::update(0.0, 0.0);
-				t = 0;
-			}
-			break;
-		case 2:
-			if (active) {
-				set_current_idx(++current_element);
-				GameObject::update(0.0, 0.0);
-				active = false;
-			}
-			break;
-		case -2:
-			if (active) {
-				set_current_idx(current_element - 1);
-				GameObject::update(0.0, 0.0);
-				active = false;
-			}
-			break;
-		case 4:
-			t = t + dt;
-			if (t >= tick_time) {
-				if (hover) {
-					set_current_idx(++current_element);
-					GameObject::update(0.0, 0.0);
-					t = 0;
-				}
-			}
-			break;
-		case -4:
-			t = t + dt;
-			if (t >= tick_time) {
-				if (hover) {
-					set_current_idx(current_element - 1);
-					GameObject::update(0.0, 0.0);
-					t = 0;
-				}
-			}
-			break;
-		default:
-			GameObject::update(0.0, 0.0);
-			break;
+	GameObject::update(0.0, 0.0);
+	if (!anims) return;
+	bool changed = false;
+	switch (state) {
+	case 1: case -1:
+		changed = anims->advance(cursor, static_cast<float>(dt));
+		break;
+	case 2: case -2:
+		if (active) {
+			changed = anims->step(cursor, state > 0 ? 1 : -1);
+			active = false;
 		}
+		break;
+	case 4: case -4:
+		if (hover) changed = anims->advance(cursor, static_cast<float>(dt));
+		break;
+	default:
+		break;
+	}
+	if (changed) invalidate();
 }
 
-void sprite::render(SDL_Renderer* ren, const Camera& cam) const {
-	if (does_show()) {
-		if (current_element >= elements.size()) {
-			std::cout << "sprite currently rendering id too large" << std::endl;
-		}
-		else {
-			elements.at(current_element)->render(ren, &get_src_rect(), &get_dst_rect(), cam, get_scale());
-		}
+void sprite::draw(render_batch& batch, const Camera& cam) const {
+	if (!does_show() || !anims) return;
+	const anim_frame* f = anims->frame(cursor);
+	if (!f) {
+		std::cout << "sprite currently rendering id too large" << std::endl;
+		return;
 	}
+	const SDL_FRect& d = get_dst_rect();
+	const float s = get_scale();
+	batch.quad(f->tex, f->src, { d.x - cam.x, d.y - cam.y, d.w * s, d.h * s });
+}
+
+// the library refreshes the frames themselves, the sprite only follows its first frame's size
+void sprite::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	GameObject::refresh_texture(key, tex_mgr);
+	const anim_clip* clip = anims ? anims->get(cursor.clip) : nullptr;
+	if (!clip || clip->frames.empty() || clip->frames[0].ref.name() != key) return;
+	const SDL_FRect& src = clip->frames[0].src;
+	get_src_rect() = src;
+	get_dst_rect().w = src.w;
+	get_dst_rect().h = src.h;
+	invalidate();
 }
 
 int sprite::action() {
 	active = true;
+	wake();
 	return -999;
 }
\ No newline at end of file
@@ -7,40 +7,63 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <map>
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
 #include "graphic_components/texture_manager.hpp"
 #include "graphic_components/camera.hpp"
 #include "graphic_components/sprites.hpp"
+#include "graphic_components/animation.hpp"
 #include <cmath>
 #include "text.hpp"
 #include "gameplay.hpp"
+#include "object_pool.hpp"
 
 //game objects
 
 class GameObject_cluster; // for ctors
+class Game_obj_container;
 
 class GameObject {
-	std::string name;
+	friend class Game_obj_container;
+	friend class GameObject_cluster;
+	const std::string* name; // interned in object_pool
 	Transform transform;
 	SDL_Texture* obj_tex;
+	texture_ref tex_ref; // keeps obj_tex resident under the texture memory budget
 	SDL_FRect src_rect;
 	SDL_FRect dst_rect;
 	bool show;
 	float scale;
 	int layer;
+	// draw order bookkeeping, only set while the object lives in a container (not for clones inside clusters)
+	Game_obj_container* owner = nullptr;
+	Uint32 order_seq = 0;  // spawn order, ties within a layer
+	int bucket_layer = 0;  // layer bucket the object is filed under
+	bool in_bucket = false;
+	SDL_Rect grid_span{ 0, 0, -1, -1 }; // pick grid cells covered: x0, y0, x1, y1 (x1 < x0 = not filed)
+	SDL_FRect bounds{ 0, 0, 0, 0 };     // world space, scaled, clusters enclose their shown items; refreshed by update_all
+	bool grid_large = false;            // too big for the grid, always tested
+	SDL_FRect bounds_seen{ 0, 0, -1, -1 }; // own_bounds() and does_show() as of the last bounds pass,
+	bool shown_seen = false;                // update_all only rebuilds bounds when these no longer match
+	bool bounds_changed() const;            // this object or any cluster item below it
+	void mark_bounds_seen();
+	bool awake = false;                  // in the owner's active list
+	GameObject_cluster* host = nullptr;  // cluster holding this item, wake() goes through it
 protected:
 	bool active = false;
 	bool hover = false;
 	void set_texture(SDL_Texture* t) { obj_tex = t; }
+	void set_region(const texture_region& r); // texture + src_rect + dst size, works for atlas entries
+	void hierarchy_changed(); // children added, the owner rebuilds its transform table
 public:
-	GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, float scale = 1.0f, bool show_it = false, int layer_in = 0);
-	GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, int x, int y, float scale = 1.0f, bool show_it = false, int layer_in = 0);
-	GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, GameObject_cluster* prn, float scale = 1.0f, bool show_it = false, int layer_in = 0);
-	GameObject(const std::string& name, const std::string& texture, const texture_manager& tex_mgr, int x, int y, GameObject_cluster* prn, float scale = 1.0f, bool show_it = false, int layer_in = 0);
+	GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, float scale = 1.0f, bool show_it = false, int layer_in = 0);
+	GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, int x, int y, float scale = 1.0f, bool show_it = false, int layer_in = 0);
+	GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, GameObject_cluster* prn, float scale = 1.0f, bool show_it = false, int layer_in = 0);
+	GameObject(const std::string& name, const std::string& texture, texture_manager& tex_mgr, int x, int y, GameObject_cluster* prn, float scale = 1.0f, bool show_it = false, int layer_in = 0);
 	GameObject(const GameObject& rhs);
 
-	const std::string& get_name() const { return name; }
+	const std::string& get_name() const { return *name; }
 	double get_world_x() const { return transform.worldX; }
 	double get_world_y() const { return transform.worldY; }
 	double get_loc_x() const { return transform.localX; }
@@ -49,13 +72,16 @@ public:
 	const Transform* get_transform() const { return &transform; }
 
 	void set_loc_position(double x, double y) { transform.setLocal(x, y); }
-	void set_loc_x(double x) { transform.localX = x; transform.dirty = true; }
-	void set_loc_y(double y) { transform.localY = y; transform.dirty = true; }
+	void set_loc_x(double x) { transform.setLocal(x, transform.localY); }
+	void set_loc_y(double y) { transform.setLocal(transform.localX, y); }
 
 	virtual void update(double dt, double speed = 400);
-	virtual void render(SDL_Renderer* ren, const Camera& cam) const;
+	virtual void draw(render_batch& batch, const Camera& cam) const;   // queues into the frame's batch
 	virtual ~GameObject() = default;
-	virtual int action() { std::cout << "my name " << name << std::endl; return -999; };
+	// objects and cluster clones live in object_pool; the virtual dtor hands sized delete the real size
+	static void* operator new(std::size_t bytes) { return object_pool::instance().allocate(bytes); }
+	static void operator delete(void* p, std::size_t bytes) { object_pool::instance().deallocate(p, bytes); }
+	virtual int action() { std::cout << "my name " << *name << std::endl; return -999; };
 	virtual std::unique_ptr<GameObject> clone() const;
 
 	SDL_Texture* get_tex();
@@ -67,17 +93,26 @@ public:
 	void set_dst_rect(double x, double y);
 
 	float get_scale() const { return scale; }
-	void set_scale(float scale_in) { scale = scale_in; }
+	const SDL_FRect& get_bounds() const { return bounds; }
+	virtual SDL_FRect own_bounds() const; // what draw() covers by itself, dst_rect * scale
+	void set_scale(float scale_in);
 
 	bool does_show() const { return show; }
-	void set_show(bool v) { show = v; }
+	void set_show(bool v);
 
 	int  get_layer() const { return layer; }
-	void set_layer(int l) { layer = l; } // call rebuild_order in the container after this
+	void set_layer(int l);
 
 	virtual bool hit_test(float wx, float wy) const;
-
-	virtual void on_hover_enter(SDL_Cursor* pointer_cursor) { hover = true; }
+	virtual void refresh_texture(const std::string& key, texture_manager& tex_mgr); // texture under key was hot-reloaded
+	virtual bool animating() const { return false; } // changes on its own over time, keeps the main loop out of idle
+	// dynamic objects are updated every frame, static ones sleep until wake(); the transform pass still moves them
+	virtual bool is_dynamic() const { return false; }
+	virtual const std::string* watched_text() const { return nullptr; } // text entry whose changes wake this object
+	void wake(); // update on the next update_all, call after changing state update() reacts to
+	void invalidate(); // looks different now, drops the cached image of the cluster holding it
+
+	virtual void on_hover_enter(SDL_Cursor* pointer_cursor) { hover = true; wake(); }
 	virtual void on_hover() {}
 	virtual void on_hover_exit(SDL_Cursor* default_cursor) { hover = false; }
 	virtual void on_hold_start(int button) {}
@@ -85,54 +120,159 @@ public:
 	virtual void on_hold_end(double seconds, int button, bool canceled) {}
 };
 
+// generational handle into Game_obj_container, goes stale (get returns nullptr) once its object is removed or replaced
+struct obj_handle {
+	Uint32 index = UINT32_MAX;
+	Uint32 generation = 0;
+	bool valid() const { return index != UINT32_MAX; }
+	bool operator==(const obj_handle&) const = default;
+};
+
 class Game_obj_container {
-	std::unordered_map<std::string, std::unique_ptr<GameObject>> objects;
+	// slot map: handles index slots, slots point into the dense arrays, removal swaps the last object into the hole
+	struct slot {
+		Uint32 dense = 0;
+		Uint32 generation = 0;
+	};
+	std::vector<slot> slots;
+	std::vector<Uint32> free_slots;
+	std::vector<std::unique_ptr<GameObject>> objects; // dense, iterated by every *_all pass
+	std::vector<Uint32> dense_slot;                   // objects[i] lives in slots[dense_slot[i]]
+	string_map<obj_handle> names;                      // name lookups for scripts and tooling, not used by the passes
+
+	// visible objects per layer, each bucket sorted by spawn order; show/hide/set_layer move one object
+	std::map<int, std::vector<GameObject*>> layer_buckets;
+	Uint32 next_seq = 0;
+
+	// layer visibility, tested once per bucket by render_all and pick_topmost
+	Uint64 layer_mask = ~Uint64(0);
+	struct scene_preset {
+		Uint64 show = 0;
+		Uint64 hide = 0;
+	};
+	string_map<scene_preset> scenes;
+
+	mutable render_batch batch;
+
+	// uniform grid over the hit bounds of visible objects, pick_topmost only tests the cell under the cursor.
+	// Filed with the buckets, re-filed by update_all / set_scale when an object crosses a cell border.
+	static constexpr float grid_cell = 256.0f;
+	static constexpr int grid_max_cells = 64;
+	std::unordered_map<Uint64, std::vector<GameObject*>> grid;
+	std::vector<GameObject*> grid_large;
+	static SDL_Rect grid_span_of(const GameObject& obj);
+	void grid_insert(GameObject& obj);
+	void grid_erase(GameObject& obj);
+
+	// flattened transforms of every object and cluster item, parent-before-child, solved once per update_all
+	transform_table transforms;
+	std::vector<GameObject*> transform_objs; // node -> object, [0] is the origin
+	bool transforms_stale = true;
+	std::vector<GameObject*> unbound_objs; // top level objects left out of the table
+	string_map<std::vector<GameObject*>> text_watchers; // text entry name -> objects drawing it, refilled with the table
+	void rebuild_transforms();
+	void update_transforms();
+	void update_bounds();
+	bool bounds_stale = true;
+
+	// objects updated by update_all; static ones drop out after one update until woken
+	std::vector<GameObject*> active, updating;
+	void drop_active(GameObject& obj);
+	bool layer_visible(int layer) const {
+		const Uint64 bit = layer_bit(layer);
+		return bit == 0 || (layer_mask & bit) != 0;
+	}
+	void bucket_insert(GameObject& obj);
+	void bucket_erase(GameObject& obj);
 
-	mutable std::vector<GameObject*> render_order_;
-	mutable bool order_dirty = true;
+	obj_handle insert(const std::string& name, std::unique_ptr<GameObject> obj);
+	GameObject* lookup(obj_handle h) const {
+		if (h.index >= slots.size() || slots[h.index].generation != h.generation) return nullptr;
+		return objects[slots[h.index].dense].get();
+	}
 public:
 
-	void rebuild_order() const;
-	void set_layer(GameObject& obj, int new_layer);
-	void invalidate_render_order() { order_dirty = true; } //call after direct change to game_obj's state, otherwise set_layer handles it
+	void rebuild_order(); // full resync, the setters keep the buckets current on their own
+	void set_layer(GameObject& obj, int new_layer) { obj.set_layer(new_layer); }
+	void sync_order(GameObject& obj); // called by GameObject::set_show / set_layer
+	void sync_bounds(GameObject& obj); // after moving or resizing an object outside update_all
+	void invalidate_transforms() { transforms_stale = true; } // hierarchy changed
+	void clear(); // drops every object at once and returns their memory to object_pool
+	void invalidate_caches(); // render targets were reset, cached clusters redraw
+	void wake(GameObject& obj);
+	void wake_text(const std::string& text); // a text entry changed, wakes every object drawing it
+	size_t active_count() const { return active.size(); }
 
 	template<typename T, typename... Args>
 	T* spawn_as(const std::string& name, Args&&... args) {
 		auto p = std::make_unique<T>(name, std::forward<Args>(args)...);
 		T* raw = p.get();
-		objects[name] = std::move(p);
+		insert(name, std::move(p));
 		return raw;
 	}
 
+	obj_handle handle_of(std::string_view name) const {
+		auto it = names.find(name);
+		return (it != names.end()) ? it->second : obj_handle{};
+	}
+	bool remove(obj_handle h);
+	bool remove(std::string_view name) { return remove(handle_of(name)); }
+	size_t size() const { return objects.size(); }
+
 	template<class T = GameObject>
-	T* get(const std::string& name) {
+	T* get(obj_handle h) {
 		static_assert(std::is_base_of_v<GameObject, T>,
 			"T must derive from GameObject");
-		auto it = objects.find(name);
-		if (it == objects.end()) return nullptr;
-		return dynamic_cast<T*>(it->second.get());
+		return dynamic_cast<T*>(lookup(h));
 	}
 
 	template<class T = GameObject>
-	const T* get(const std::string& name) const {
+	const T* get(obj_handle h) const {
 		static_assert(std::is_base_of_v<GameObject, T>,
 			"T must derive from GameObject");
-		auto it = objects.find(name);
-		if (it == objects.end()) return nullptr;
-		return dynamic_cast<const T*>(it->second.get());
+		return dynamic_cast<const T*>(lookup(h));
 	}
+
+	template<class T = GameObject>
+	T* get(std::string_view name) { return get<T>(handle_of(name)); }
+
+	template<class T = GameObject>
+	const T* get(std::string_view name) const { return get<T>(handle_of(name)); }
 	void update_all(double dtSeconds, double speed = 400);
 	void render_all(SDL_Renderer* ren, const Camera& cam) const;
 	void set_scale_all(float new_scale);
-	void layer_switch(int layer, bool enabled);
+
+	// bit n = layer n, layers outside 0..63 can't be masked and always draw
+	static constexpr Uint64 layer_bit(int layer) { return (layer >= 0 && layer < 64) ? (Uint64(1) << layer) : 0; }
+	static Uint64 layer_set(std::initializer_list<int> layers) {
+		Uint64 m = 0;
+		for (int l : layers) m |= layer_bit(l);
+		return m;
+	}
+	void layer_switch(int layer, bool enabled); // O(1), the objects' own show flags are untouched
+	void set_layer_mask(Uint64 mask) { layer_mask = mask; }
+	Uint64 get_layer_mask() const { return layer_mask; }
+
+	// scene preset: layers to turn on and off, applied in one mask update
+	void define_scene(const std::string& name, Uint64 show, Uint64 hide) { scenes[name] = { show, hide }; }
+	bool apply_scene(std::string_view name);
 
 	GameObject* pick_topmost(float wx, float wy) const;
+	const render_batch_stats& render_stats() const { return batch.stats(); } // previous frame
+	bool animating() const; // any active object on a visible layer is animating
+	void refresh_texture(const std::string& key, texture_manager& tex_mgr);
 };
 
 //Game object cluster -----------------------------------------------------------------------------------
 
 class GameObject_cluster: public GameObject {
 	std::vector<std::unique_ptr<GameObject>> items;
+	// opt-in render target cache: self + items drawn once into cache_tex, then shown as one quad
+	bool cached = false;
+	mutable SDL_Texture* cache_tex = nullptr;
+	mutable bool cache_dirty = true;
+	void draw_direct(render_batch& batch, const Camera& cam) const;
+	bool redraw_cache(SDL_Renderer* ren) const;
 public:
 	using GameObject::GameObject;
 
@@ -141,9 +281,18 @@ public:
 	void add_item_local(const GameObject& obj_in, int lx, int ly, bool show_in_clust = false);
 	void add_item_world(const GameObject& obj_in, bool show_in_clust = false);
 
+	const std::vector<std::unique_ptr<GameObject>>& get_items() const { return items; }
+	bool is_dynamic() const override; // while any item is
+
+	void set_cached(bool enabled);
+	bool is_cached() const { return cached; }
+	void invalidate_cache(); // redrawn on the next draw, also after render targets were lost
+
 	void update(double dt, double speed = 400) override;
-	void render(SDL_Renderer* ren, const Camera& cam) const override;
-	~GameObject_cluster() = default;
+	void draw(render_batch& batch, const Camera& cam) const override;
+	void refresh_texture(const std::string& key, texture_manager& tex_mgr) override;
+	bool animating() const override;
+	~GameObject_cluster();
 };
 
 // DERIVED OBJECTS --------------------------------------------------------------------------------------
@@ -158,7 +307,6 @@ public:
 	std::unique_ptr<GameObject> clone() const override { return std::make_unique<Button>(*this); }
 
 	void update(double dt, double speed = 400) override;
-	using GameObject::render;
 	void on_hover_enter(SDL_Cursor* pointer_cursor) override;
 	void on_hover_exit(SDL_Cursor* default_cursor) override;
 	void switch_enable(bool new_value) { enabled = new_value; }
@@ -169,7 +317,10 @@ public:
 
 class Text_Button : public Button {
 	texture_manager& tex_mgr;
-	SDL_Color default_bg_color;
+	const texture_manager::TextEntry* text = nullptr; // owned by tex_mgr and shared by clones, drawn as background + border + text layers
+	Uint32 text_generation = 0; // text->generation this button last synced to
+	void attach_text();
+	void sync_text_size();
 public:
 	Text_Button(const std::string& name, const std::string& texture, texture_manager& tex_mgr_in, float scale = 1.0f, bool show_it = false, int layer_in = 0, int variable = 0);
 	Text_Button(const std::string& name, const std::string& texture, texture_manager& tex_mgr_in, int x, int y, float scale = 1.0f, bool show_it = false, int layer_in = 0, int variable = 0);
@@ -179,6 +330,8 @@ public:
 	std::unique_ptr<GameObject> clone() const override { return std::make_unique<Text_Button>(*this); }
 
 	void update(double dt, double speed = 400) override;
+	const std::string* watched_text() const override { return text ? &text->name : nullptr; }
+	void draw(render_batch& batch, const Camera& cam) const override;
 	void on_hover_enter(SDL_Cursor* pointer_cursor) override;
 	void on_hover_exit(SDL_Cursor* default_cursor) override;
 	void set_text(const std::string& new_text);
@@ -193,13 +346,15 @@ class streched_bg_obj : public GameObject {
 	strech_bg image;
 public:
 	using GameObject::GameObject;
-	void set_texture(const std::string& texture, const texture_manager& tex_mgr);
+	void set_texture(const std::string& texture, texture_manager& tex_mgr);
 	void set_screen(int screen_w, int screen_h);
-	void init(const std::string& texture, const texture_manager& tex_mgr, int screen_w, int screen_h);
+	void init(const std::string& texture, texture_manager& tex_mgr, int screen_w, int screen_h);
 
 	void update(double dt, double speed = 400) override;
 
-	void render(SDL_Renderer* ren, const Camera& cam) const override;
+	void draw(render_batch& batch, const Camera& cam) const override;
+	void refresh_texture(const std::string& key, texture_manager& tex_mgr) override;
+	SDL_FRect own_bounds() const override; // fills the screen wherever the camera is
 
 	~streched_bg_obj() = default;
 };
@@ -207,27 +362,27 @@ public:
 //sprite object
 
 class sprite : public GameObject {
-	std::vector<std::unique_ptr<sprite_component>> elements;
+	const anim_library* anims = nullptr; // shared clips, the sprite only keeps its cursor
+	anim_cursor cursor;
 	int state = 1; //states in docs
-	int current_element = 0;
-	double t = 0;
-	double tick_time = 0.25;
 public:
 	using GameObject::GameObject;
 
-	void add_element(const std::string& texture, const texture_manager& tex_mgr);
-	//void add_elements_batch(const std::string& name);
-	std::unique_ptr<sprite_component>& get_element(size_t idx);
+	void set_clip(const anim_library& lib, clip_id id); // sized by the clip's first frame, restarts playback
+	clip_id get_clip() const { return cursor.clip; }
 
 	int get_state() const { return state; }
-	void set_state(int new_State) { state = new_State; }
+	void set_state(int new_State);
 
-	size_t get_current_idx() const { return static_cast<size_t>(current_element); }
+	size_t get_current_idx() const { return cursor.frame; }
 	void set_current_idx(int idx);
 
 	void update(double dt, double speed = 1) override;
 
-	void render(SDL_Renderer* ren, const Camera& cam) const override;
+	void draw(render_batch& batch, const Camera& cam) const override;
+	void refresh_texture(const std::string& key, texture_manager& tex_mgr) override;
+	bool animating() const override;
+	bool is_dynamic() const override { return animating(); }
 
 	int action() override;
 };
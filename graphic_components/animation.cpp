@@ -0,0 +1,164 @@
+#include "animation.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+	constexpr float min_duration = 0.001f; // keeps advance() from spinning on zero length frames
+
+	bool parse_mode(std::string_view s, anim_mode& out) {
+		if (s == "once") out = anim_mode::once;
+		else if (s == "loop") out = anim_mode::loop;
+		else if (s == "ping_pong") out = anim_mode::ping_pong;
+		else return false;
+		return true;
+	}
+
+	// moves one frame in c.dir, the clip's mode decides what happens at either end
+	void next_frame(anim_cursor& c, const anim_clip& clip) {
+		const Sint64 n = static_cast<Sint64>(clip.frames.size());
+		const Sint64 f = static_cast<Sint64>(c.frame) + c.dir;
+		if (f >= 0 && f < n) {
+			c.frame = static_cast<Uint32>(f);
+			return;
+		}
+		switch (clip.mode) {
+		case anim_mode::loop:
+			c.frame = f < 0 ? static_cast<Uint32>(n - 1) : 0;
+			break;
+		case anim_mode::ping_pong:
+			c.dir = -c.dir;
+			if (n > 1) c.frame = static_cast<Uint32>(c.frame + c.dir);
+			break;
+		case anim_mode::once:
+			c.playing = false;
+			c.t = 0;
+			break;
+		}
+	}
+}
+
+clip_id anim_library::add(const std::string& name, const std::vector<std::string>& frame_keys, const std::vector<float>& durations, anim_mode mode, texture_manager& tex_mgr) {
+	anim_clip clip;
+	clip.name = name;
+	clip.mode = mode;
+	clip.frames.reserve(frame_keys.size());
+	for (size_t i = 0; i < frame_keys.size(); ++i) {
+		anim_frame f;
+		f.ref = tex_mgr.acquire(frame_keys[i]);
+		f.tex = f.ref.region().tex;
+		f.src = f.ref.region().src;
+		if (!f.tex) std::cerr << "animation '" << name << "': texture not found for '" << frame_keys[i] << "'\n";
+		const float d = durations.empty() ? 0.1f : durations[std::min(i, durations.size() - 1)];
+		f.duration = std::max(d, min_duration);
+		clip.frames.push_back(std::move(f));
+	}
+
+	if (auto it = by_name.find(name); it != by_name.end()) {
+		clips[it->second] = std::move(clip);
+		return it->second;
+	}
+	const clip_id id = static_cast<clip_id>(clips.size());
+	clips.push_back(std::move(clip));
+	by_name.emplace(name, id);
+	return id;
+}
+
+clip_id anim_library::add_sequence(const std::string& name, const std::string& key_prefix, float frame_duration, anim_mode mode, texture_manager& tex_mgr) {
+	std::vector<std::string> keys;
+	for (int i = 1;; ++i) {
+		std::string key = key_prefix + std::to_string(i);
+		if (!tex_mgr.has(key)) break;
+		keys.push_back(std::move(key));
+	}
+	return add(name, keys, { frame_duration }, mode, tex_mgr);
+}
+
+size_t anim_library::load(const std::string& path, texture_manager& tex_mgr) {
+	std::ifstream file(path);
+	if (!file) {
+		std::cerr << "couldn't open " << path << std::endl;
+		return 0;
+	}
+	size_t added = 0;
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		std::stringstream fields(line);
+		std::string name, mode_str, field;
+		anim_mode mode;
+		if (!std::getline(fields, name, ';') || !std::getline(fields, mode_str, ';') || !parse_mode(mode_str, mode)) {
+			std::cerr << path << ": bad clip line '" << line << "'\n";
+			continue;
+		}
+		std::vector<std::string> keys;
+		std::vector<float> durations;
+		while (std::getline(fields, field, ';')) {
+			const size_t colon = field.rfind(':');
+			if (colon == std::string::npos) {
+				std::cerr << path << ": frame '" << field << "' has no duration\n";
+				continue;
+			}
+			keys.push_back(field.substr(0, colon));
+			durations.push_back(std::strtof(field.c_str() + colon + 1, nullptr));
+		}
+		if (keys.empty()) continue;
+		add(name, keys, durations, mode, tex_mgr);
+		++added;
+	}
+	return added;
+}
+
+void anim_library::clear() {
+	clips.clear();
+	by_name.clear();
+}
+
+clip_id anim_library::find(std::string_view name) const {
+	auto it = by_name.find(name);
+	return it != by_name.end() ? it->second : no_clip;
+}
+
+bool anim_library::advance(anim_cursor& c, float dt) const {
+	if (!c.playing || c.clip >= clips.size()) return false;
+	const anim_clip& clip = clips[c.clip];
+	if (clip.frames.empty()) return false;
+	const Uint32 start = c.frame;
+	c.t += dt;
+	while (c.playing && c.t >= clip.frames[c.frame].duration) {
+		c.t -= clip.frames[c.frame].duration;
+		next_frame(c, clip);
+	}
+	return c.frame != start;
+}
+
+bool anim_library::step(anim_cursor& c, int delta) const {
+	if (c.clip >= clips.size() || clips[c.clip].frames.empty() || delta == 0) return false;
+	const Uint32 start = c.frame;
+	const Sint8 dir = c.dir;
+	const bool playing = c.playing;
+	c.dir = delta > 0 ? 1 : -1;
+	for (int i = std::abs(delta); i > 0; --i) next_frame(c, clips[c.clip]);
+	c.dir = dir;
+	c.playing = playing;
+	c.t = 0;
+	return c.frame != start;
+}
+
+const anim_frame* anim_library::frame(const anim_cursor& c) const {
+	if (c.clip >= clips.size()) return nullptr;
+	const anim_clip& clip = clips[c.clip];
+	return c.frame < clip.frames.size() ? &clip.frames[c.frame] : nullptr;
+}
+
+void anim_library::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	for (auto& clip : clips) {
+		for (auto& f : clip.frames) {
+			if (!f.ref || f.ref.name() != key) continue;
+			const texture_region r = tex_mgr.get_region(key);
+			f.tex = r.tex;
+			f.src = r.src;
+		}
+	}
+}
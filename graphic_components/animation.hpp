@@ -0,0 +1,61 @@
+#pragma once
+#ifndef animation_hpp
+#define animation_hpp
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <SDL3/SDL.h>
+#include "texture_manager.hpp"
+
+enum class anim_mode : Uint8 { once, loop, ping_pong };
+
+using clip_id = Uint32;
+inline constexpr clip_id no_clip = 0xFFFFFFFFu;
+
+struct anim_frame {
+	texture_ref ref; // keeps the frame resident
+	SDL_Texture* tex = nullptr;
+	SDL_FRect src{ 0, 0, 0, 0 };
+	float duration = 0.1f; // seconds
+};
+
+struct anim_clip {
+	std::string name;
+	std::vector<anim_frame> frames;
+	anim_mode mode = anim_mode::loop;
+};
+
+// playback position, the only animation state an instance keeps
+struct anim_cursor {
+	clip_id clip = no_clip;
+	Uint32 frame = 0;
+	float t = 0;          // seconds into the current frame
+	Sint8 dir = 1;        // 1 forward, -1 backward, ping-pong flips it
+	bool playing = false; // a once clip stops itself on its last frame
+};
+
+// Clips are built once and shared by every instance playing them, instances only hold an anim_cursor.
+class anim_library {
+	std::vector<anim_clip> clips;
+	string_map<clip_id> by_name;
+public:
+	// durations: one per frame, or a single one for every frame. Same name again replaces the clip
+	clip_id add(const std::string& name, const std::vector<std::string>& frame_keys, const std::vector<float>& durations, anim_mode mode, texture_manager& tex_mgr);
+	clip_id add_sequence(const std::string& name, const std::string& key_prefix, float frame_duration, anim_mode mode, texture_manager& tex_mgr); // key_prefix1, key_prefix2, ... while they exist
+	// one clip per line: name;once|loop|ping_pong;frame_key:seconds;frame_key:seconds;...  returns clips added
+	size_t load(const std::string& path, texture_manager& tex_mgr);
+	void clear();
+
+	clip_id find(std::string_view name) const;
+	const anim_clip* get(clip_id id) const { return id < clips.size() ? &clips[id] : nullptr; }
+	size_t size() const { return clips.size(); }
+
+	bool advance(anim_cursor& c, float dt) const; // true if the frame changed
+	bool step(anim_cursor& c, int delta) const;   // manual step, wraps like the clip's mode
+	const anim_frame* frame(const anim_cursor& c) const;
+
+	void refresh_texture(const std::string& key, texture_manager& tex_mgr); // frames using key were hot-reloaded
+};
+
+#endif
@@ -0,0 +1,363 @@
+#include "asset_pack.hpp"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+	std::string to_lower(std::string s) {
+		std::transform(s.begin(), s.end(), s.begin(),
+			[](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return s;
+	}
+
+	constexpr Uint64 align16(Uint64 v) { return (v + 15) & ~Uint64(15); }
+}
+
+bool is_image_path(const std::string& path) {
+	const std::string ext = to_lower(fs::path(path).extension().string());
+	return ext == ".png" || ext == ".jpg" || ext == ".jpeg";
+}
+
+void list_image_files(const std::string& folder_path, std::vector<image_file>& out) {
+	const fs::path base = folder_path;
+	std::error_code ec;
+	for (fs::recursive_directory_iterator it(base, ec), end; it != end; it.increment(ec)) {
+		if (ec) {
+			std::cerr << "Filesystem iteration error: " << ec.message() << "\n";
+			break;
+		}
+
+		const fs::directory_entry& entry = *it;
+		if (!entry.is_regular_file()) continue;
+
+		const fs::path& p = entry.path();
+		if (!is_image_path(p.string())) continue;
+
+		// key = relative_dir / stem  (no extension), using '/' separators
+		std::error_code ec2;
+		fs::path rel_dir = fs::relative(p.parent_path(), base, ec2);
+		if (ec2) rel_dir.clear();
+
+		fs::path key_path = (rel_dir.empty() || rel_dir == ".") ? p.stem() : (rel_dir / p.stem());
+		out.push_back({ key_path.generic_string(), p.lexically_normal().generic_string() });
+	}
+}
+
+bool file_stamp(const std::string& path, Uint64& size, Sint64& mtime) {
+	std::error_code ec;
+	const auto sz = fs::file_size(path, ec);
+	if (ec) return false;
+	const auto t = fs::last_write_time(path, ec);
+	if (ec) return false;
+	size = static_cast<Uint64>(sz);
+	mtime = static_cast<Sint64>(t.time_since_epoch().count());
+	return true;
+}
+
+std::vector<SDL_Point> shelf_pack(std::vector<SDL_Rect>& slots, std::vector<int>& page_of, int page_size, int pad) {
+	std::vector<size_t> order(slots.size());
+	for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return slots[a].h > slots[b].h; });
+
+	page_of.assign(slots.size(), -1);
+	std::vector<SDL_Point> extents;
+	int page = -1, shelf_x = 0, shelf_y = 0, shelf_h = 0;
+	for (size_t i : order) {
+		SDL_Rect& slot = slots[i];
+		const int w = slot.w + 2 * pad;
+		const int h = slot.h + 2 * pad;
+		if (shelf_x + w > page_size) { // next shelf
+			shelf_y += shelf_h;
+			shelf_x = shelf_h = 0;
+		}
+		if (page < 0 || shelf_y + h > page_size) { // next page
+			++page;
+			shelf_x = shelf_y = shelf_h = 0;
+			extents.push_back({ 0, 0 });
+		}
+		page_of[i] = page;
+		slot.x = shelf_x + pad;
+		slot.y = shelf_y + pad;
+		shelf_x += w;
+		shelf_h = std::max(shelf_h, h);
+		extents[page].x = std::max(extents[page].x, shelf_x);
+		extents[page].y = std::max(extents[page].y, shelf_y + shelf_h);
+	}
+	return extents;
+}
+
+// PACKER
+
+bool write_asset_pack(const std::vector<std::string>& folders, const std::string& out_path, bool atlas, int page_size, int padding) {
+	const SDL_PixelFormat format = SDL_PIXELFORMAT_ARGB8888; // what the D3D/GL/Vulkan renderers keep textures in
+	const int bpp = SDL_BYTESPERPIXEL(format);
+
+	std::vector<image_file> files;
+	for (const auto& folder : folders) list_image_files(folder, files);
+
+	// one decode per file, keys reaching the same file share its pixels
+	struct source {
+		SDL_Surface* surf;
+		SDL_Rect slot;
+		int page;
+		Uint64 file_size;
+		Sint64 file_mtime;
+	};
+	std::vector<source> sources;
+	std::unordered_map<std::string, size_t> source_of_path;
+	std::vector<std::pair<std::string, size_t>> entries; // key -> source
+	std::unordered_set<std::string> keys;
+
+	for (const auto& f : files) {
+		if (!keys.insert(f.key).second) continue; // first folder wins, like the loader
+		auto found = source_of_path.find(f.path);
+		if (found == source_of_path.end()) {
+			SDL_Surface* loaded = IMG_Load(f.path.c_str());
+			if (!loaded) {
+				std::cerr << "Failed to load image: " << f.path << "\n";
+				continue;
+			}
+			SDL_Surface* surf = SDL_ConvertSurface(loaded, format);
+			SDL_DestroySurface(loaded);
+			if (!surf) {
+				std::cerr << "Failed to convert image: " << f.path << "\n";
+				continue;
+			}
+			Uint64 file_size = 0;
+			Sint64 file_mtime = 0;
+			file_stamp(f.path, file_size, file_mtime);
+			found = source_of_path.emplace(f.path, sources.size()).first;
+			sources.push_back({ surf, { 0, 0, surf->w, surf->h }, -1, file_size, file_mtime });
+		}
+		entries.emplace_back(f.key, found->second);
+	}
+
+	// atlas what fits a page, everything else gets a page of its own
+	std::vector<SDL_Rect> slots;
+	std::vector<size_t> slot_source;
+	for (size_t i = 0; i < sources.size(); ++i) {
+		const SDL_Rect& s = sources[i].slot;
+		if (atlas && s.w + 2 * padding <= page_size && s.h + 2 * padding <= page_size) {
+			slots.push_back(s);
+			slot_source.push_back(i);
+		}
+	}
+	std::vector<int> page_of;
+	std::vector<SDL_Point> extents = shelf_pack(slots, page_of, page_size, padding);
+	for (size_t i = 0; i < slots.size(); ++i) {
+		sources[slot_source[i]].slot = slots[i];
+		sources[slot_source[i]].page = page_of[i];
+	}
+	for (auto& s : sources) {
+		if (s.page >= 0) continue;
+		s.page = static_cast<int>(extents.size());
+		extents.push_back({ s.slot.w, s.slot.h });
+	}
+
+	std::vector<SDL_Surface*> sheets;
+	bool ok = true;
+	for (const SDL_Point& e : extents) {
+		SDL_Surface* sheet = SDL_CreateSurface(e.x, e.y, format);
+		if (!sheet) {
+			SDL_Log("SDL_CreateSurface failed: %s", SDL_GetError());
+			ok = false;
+			break;
+		}
+		SDL_FillSurfaceRect(sheet, nullptr, SDL_MapSurfaceRGBA(sheet, 0, 0, 0, 0));
+		sheets.push_back(sheet);
+	}
+	if (ok) {
+		for (auto& s : sources) {
+			SDL_SetSurfaceBlendMode(s.surf, SDL_BLENDMODE_NONE); // copy alpha as-is
+			SDL_BlitSurface(s.surf, nullptr, sheets[s.page], &s.slot);
+		}
+	}
+
+	if (ok) {
+		std::string strings;
+		std::vector<pack_image> images;
+		for (const auto& [key, src] : entries) {
+			const source& s = sources[src];
+			images.push_back({ static_cast<Uint32>(strings.size()), static_cast<Uint32>(key.size()), s.page, s.slot.x, s.slot.y, s.slot.w, s.slot.h, 0, s.file_size, s.file_mtime });
+			strings += key;
+		}
+
+		pack_header header{ pack_magic, pack_version, static_cast<Uint32>(format), static_cast<Uint32>(sheets.size()), static_cast<Uint32>(images.size()), static_cast<Uint32>(strings.size()) };
+		std::vector<pack_page> pages;
+		Uint64 offset = align16(sizeof(pack_header) + sheets.size() * sizeof(pack_page) + images.size() * sizeof(pack_image) + strings.size());
+		for (SDL_Surface* sheet : sheets) {
+			const Uint32 pitch = static_cast<Uint32>(sheet->w * bpp);
+			pages.push_back({ offset, static_cast<Uint32>(sheet->w), static_cast<Uint32>(sheet->h), pitch, 0 });
+			offset = align16(offset + static_cast<Uint64>(pitch) * sheet->h);
+		}
+
+		std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			std::cerr << "Failed to open pack for writing: " << out_path << "\n";
+			ok = false;
+		}
+		else {
+			const char zeros[16] = {};
+			auto pad_to = [&](Uint64 pos) {
+				const Uint64 at = static_cast<Uint64>(out.tellp());
+				if (pos > at) out.write(zeros, static_cast<std::streamsize>(pos - at));
+			};
+			out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			out.write(reinterpret_cast<const char*>(pages.data()), pages.size() * sizeof(pack_page));
+			out.write(reinterpret_cast<const char*>(images.data()), images.size() * sizeof(pack_image));
+			out.write(strings.data(), strings.size());
+			for (size_t p = 0; p < sheets.size(); ++p) {
+				pad_to(pages[p].offset);
+				const Uint8* row = static_cast<const Uint8*>(sheets[p]->pixels);
+				for (int y = 0; y < sheets[p]->h; ++y, row += sheets[p]->pitch) { // surface rows may be padded
+					out.write(reinterpret_cast<const char*>(row), pages[p].pitch);
+				}
+			}
+			ok = static_cast<bool>(out);
+			if (!ok) std::cerr << "Failed to write pack: " << out_path << "\n";
+		}
+		if (ok) {
+			std::cout << "pack: wrote " << images.size() << " images on " << pages.size() << " page(s) to " << out_path << std::endl;
+		}
+	}
+
+	for (SDL_Surface* sheet : sheets) SDL_DestroySurface(sheet);
+	for (auto& s : sources) SDL_DestroySurface(s.surf);
+	return ok;
+}
+
+// MAPPED PACK
+
+bool asset_pack::open(const std::string& path) {
+	close();
+	std::error_code ec;
+	if (!fs::is_regular_file(path, ec)) return false; // no pack is fine, callers fall back to the folders
+
+#ifdef _WIN32
+	HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (f == INVALID_HANDLE_VALUE) {
+		std::cerr << "Failed to open pack: " << path << "\n";
+		return false;
+	}
+	file = f;
+	LARGE_INTEGER file_size{};
+	if (!GetFileSizeEx(f, &file_size) || file_size.QuadPart == 0) {
+		close();
+		return false;
+	}
+	mapping = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping) data = static_cast<const Uint8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	size = static_cast<size_t>(file_size.QuadPart);
+#else
+	fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		std::cerr << "Failed to open pack: " << path << "\n";
+		return false;
+	}
+	struct stat st{};
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close();
+		return false;
+	}
+	void* m = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	if (m != MAP_FAILED) data = static_cast<const Uint8*>(m);
+	size = static_cast<size_t>(st.st_size);
+#endif
+	if (!data) {
+		std::cerr << "Failed to map pack: " << path << "\n";
+		close();
+		return false;
+	}
+	if (!validate()) {
+		std::cerr << "Malformed or outdated pack, ignoring: " << path << "\n";
+		close();
+		return false;
+	}
+	return true;
+}
+
+void asset_pack::close() {
+#ifdef _WIN32
+	if (data) UnmapViewOfFile(data);
+	if (mapping) CloseHandle(mapping);
+	if (file) CloseHandle(file);
+	mapping = file = nullptr;
+#else
+	if (data) munmap(const_cast<Uint8*>(data), size);
+	if (fd >= 0) ::close(fd);
+	fd = -1;
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+// bounds-checks every table entry once so lookups can index blindly
+bool asset_pack::validate() const {
+	if (size < sizeof(pack_header)) return false;
+	const pack_header& h = header();
+	if (h.magic != pack_magic || h.version != pack_version) return false;
+	const int bpp = SDL_BYTESPERPIXEL(static_cast<SDL_PixelFormat>(h.pixel_format));
+	if (bpp <= 0) return false;
+
+	const Uint64 tables = sizeof(pack_header) + Uint64(h.page_count) * sizeof(pack_page) + Uint64(h.image_count) * sizeof(pack_image);
+	if (tables + h.strings_size > size) return false;
+
+	for (Uint32 i = 0; i < h.page_count; ++i) {
+		const pack_page& p = page(i);
+		if (p.pitch < Uint64(p.w) * bpp || p.offset % 4 != 0) return false;
+		if (p.offset < tables + h.strings_size || p.offset + Uint64(p.pitch) * p.h > size) return false;
+	}
+	for (Uint32 i = 0; i < h.image_count; ++i) {
+		const pack_image& img = image(i);
+		if (Uint64(img.key_offset) + img.key_size > h.strings_size || img.key_size == 0) return false;
+		if (img.page < 0 || Uint32(img.page) >= h.page_count || img.x < 0 || img.y < 0 || img.w <= 0 || img.h <= 0) return false;
+		const pack_page& p = page(img.page);
+		if (Uint64(img.x) + img.w > p.w || Uint64(img.y) + img.h > p.h) return false;
+	}
+	return true;
+}
+
+// stats every file the packer would pick up, no decoding
+bool asset_pack::matches(const std::vector<std::string>& folders) const {
+	std::vector<image_file> files;
+	for (const auto& folder : folders) list_image_files(folder, files);
+
+	std::unordered_map<std::string_view, const pack_image*> packed;
+	for (Uint32 i = 0; i < header().image_count; ++i) packed.emplace(key(image(i)), &image(i));
+
+	std::unordered_set<std::string> keys;
+	for (const auto& f : files) {
+		if (!keys.insert(f.key).second) continue; // first folder wins, like the packer
+		auto it = packed.find(f.key);
+		if (it == packed.end()) return false; // added since
+		Uint64 size = 0;
+		Sint64 mtime = 0;
+		if (!file_stamp(f.path, size, mtime)) continue; // unreadable, the packer skipped it too
+		if (it->second->source_size != size || it->second->source_mtime != mtime) return false;
+	}
+	return keys.size() == packed.size(); // nothing removed
+}
+
+const pack_image& asset_pack::image(Uint32 i) const {
+	const Uint8* table = data + sizeof(pack_header) + Uint64(header().page_count) * sizeof(pack_page);
+	return reinterpret_cast<const pack_image*>(table)[i];
+}
+
+std::string_view asset_pack::key(const pack_image& img) const {
+	const Uint8* strings = data + sizeof(pack_header) + Uint64(header().page_count) * sizeof(pack_page) + Uint64(header().image_count) * sizeof(pack_image);
+	return std::string_view(reinterpret_cast<const char*>(strings) + img.key_offset, img.key_size);
+}
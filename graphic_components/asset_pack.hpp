@@ -0,0 +1,88 @@
+#pragma once
+#ifndef asset_pack_hpp
+#define asset_pack_hpp
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <SDL3/SDL.h>
+#include <SDL3_image/SDL_image.h>
+
+// image file found under a load folder, key = relative dir / stem with '/' separators
+struct image_file {
+	std::string key;
+	std::string path;
+};
+void list_image_files(const std::string& folder_path, std::vector<image_file>& out);
+bool file_stamp(const std::string& path, Uint64& size, Sint64& mtime); // false if it can't be read
+bool is_image_path(const std::string& path); // .png / .jpg / .jpeg, any case
+
+// Shelf packing, tallest first. slots come in with w/h set and leave with x/y inside their page,
+// page_of gets the page index of every slot. Returns the used size of each page.
+// Every slot must fit a page on its own (w/h + 2 * pad <= page_size).
+std::vector<SDL_Point> shelf_pack(std::vector<SDL_Rect>& slots, std::vector<int>& page_of, int page_size, int pad);
+
+// Pre-decoded asset pack, written offline by write_asset_pack:
+// pack_header | pack_page[page_count] | pack_image[image_count] | key strings | pixel blobs (16 byte aligned)
+constexpr Uint32 pack_magic = 0x4B415046; // "FPAK"
+constexpr Uint32 pack_version = 2;
+
+struct pack_header {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 pixel_format; // SDL_PixelFormat of every blob
+	Uint32 page_count;
+	Uint32 image_count;
+	Uint32 strings_size;
+};
+
+struct pack_page {
+	Uint64 offset; // from the start of the file
+	Uint32 w, h;
+	Uint32 pitch;
+	Uint32 reserved;
+};
+
+struct pack_image {
+	Uint32 key_offset; // into the string block
+	Uint32 key_size;
+	Sint32 page;
+	Sint32 x, y, w, h;
+	Uint32 reserved;
+	Uint64 source_size;  // size and write time of the image file it was decoded from,
+	Sint64 source_mtime; // a mismatch means the pack is older than the art
+};
+
+// folders are scanned like texture_manager::load_textures_from_folder, so keys match the folder loader
+bool write_asset_pack(const std::vector<std::string>& folders, const std::string& out_path, bool atlas = true, int page_size = 4096, int padding = 2);
+
+// read-only mapping of a pack file, blobs are uploaded straight from it
+class asset_pack {
+	const Uint8* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+	bool validate() const;
+public:
+	asset_pack() = default;
+	~asset_pack() { close(); }
+	asset_pack(const asset_pack&) = delete;
+	asset_pack& operator=(const asset_pack&) = delete;
+
+	bool open(const std::string& path); // false if missing or malformed
+	void close();
+	bool is_open() const { return data != nullptr; }
+
+	const pack_header& header() const { return *reinterpret_cast<const pack_header*>(data); }
+	const pack_page& page(Uint32 i) const { return reinterpret_cast<const pack_page*>(data + sizeof(pack_header))[i]; }
+	const pack_image& image(Uint32 i) const;
+	std::string_view key(const pack_image& img) const;
+	const void* pixels(const pack_page& p) const { return data + p.offset; }
+	bool matches(const std::vector<std::string>& folders) const; // same image files, sizes and write times as when written
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "asset_watcher.hpp"
+#include "asset_pack.hpp"
+#include <algorithm>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+	void push_unique(std::vector<std::string>& out, std::string path) {
+		if (std::find(out.begin(), out.end(), path) == out.end()) out.push_back(std::move(path));
+	}
+}
+
+#ifdef __linux__
+
+asset_watcher::asset_watcher(const std::vector<std::string>& folders_in, double) : folders(folders_in) {
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0) {
+		std::cerr << "inotify_init1 failed, hot reload disabled\n";
+		return;
+	}
+	for (const auto& folder : folders) add_watches(folder);
+}
+
+asset_watcher::~asset_watcher() {
+	if (fd >= 0) close(fd);
+}
+
+// inotify isn't recursive, every subdirectory gets its own watch
+void asset_watcher::add_watches(const std::string& folder) {
+	const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+	auto watch = [&](const fs::path& dir) {
+		const int wd = inotify_add_watch(fd, dir.c_str(), mask);
+		if (wd >= 0) watch_dirs.emplace(wd, dir.lexically_normal().generic_string()); // a dir watched twice keeps its first path
+	};
+	watch(folder);
+	std::error_code ec;
+	for (fs::recursive_directory_iterator it(folder, ec), end; it != end; it.increment(ec)) {
+		if (ec) break;
+		if (it->is_directory()) watch(it->path());
+	}
+}
+
+void asset_watcher::poll(std::vector<std::string>& changed) {
+	if (fd < 0) return;
+	alignas(inotify_event) char buf[4096];
+	for (;;) {
+		const ssize_t len = read(fd, buf, sizeof(buf));
+		if (len <= 0) break; // EAGAIN: drained
+		for (ssize_t off = 0; off < len;) {
+			const inotify_event* ev = reinterpret_cast<const inotify_event*>(buf + off);
+			off += sizeof(inotify_event) + ev->len;
+			auto dir = watch_dirs.find(ev->wd);
+			if (dir == watch_dirs.end() || ev->len == 0) continue;
+
+			const fs::path p = fs::path(dir->second) / ev->name;
+			if (ev->mask & IN_ISDIR) {
+				if (ev->mask & IN_CREATE) add_watches(p.string());
+				continue;
+			}
+			if (ev->mask & IN_CREATE) continue; // contents arrive with IN_CLOSE_WRITE
+			if (is_image_path(p.string())) push_unique(changed, p.lexically_normal().generic_string());
+		}
+	}
+}
+
+#else
+
+asset_watcher::asset_watcher(const std::vector<std::string>& folders_in, double poll_interval)
+	: folders(folders_in), interval_ms(static_cast<Uint64>(poll_interval * 1000.0)) {
+	scanning = std::async(std::launch::async, &asset_watcher::scan, this); // first pass only records stamps
+}
+
+asset_watcher::~asset_watcher() {
+	if (scanning.valid()) scanning.wait();
+}
+
+// records every image's last write time, returns the ones that moved since the previous scan
+std::vector<std::string> asset_watcher::scan() {
+	const bool first = stamps.empty();
+	std::vector<std::string> changed;
+	std::vector<image_file> files;
+	for (const auto& folder : folders) list_image_files(folder, files);
+	for (auto& f : files) {
+		std::error_code ec;
+		const auto stamp = fs::last_write_time(f.path, ec);
+		if (ec) continue;
+		auto [it, inserted] = stamps.try_emplace(f.path, stamp);
+		if (!inserted && it->second != stamp) {
+			it->second = stamp;
+			if (!first) push_unique(changed, f.path);
+		}
+	}
+	return changed;
+}
+
+void asset_watcher::poll(std::vector<std::string>& changed) {
+	if (scanning.valid()) {
+		if (scanning.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+		for (auto& path : scanning.get()) push_unique(changed, std::move(path));
+		next_scan_ms = SDL_GetTicks() + interval_ms;
+		return;
+	}
+	if (SDL_GetTicks() < next_scan_ms) return;
+	scanning = std::async(std::launch::async, &asset_watcher::scan, this);
+}
+
+#endif
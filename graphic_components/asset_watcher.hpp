@@ -0,0 +1,37 @@
+#pragma once
+#ifndef asset_watcher_hpp
+#define asset_watcher_hpp
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+#include <future>
+#include <SDL3/SDL.h>
+
+// Reports image files rewritten under the watched folders, paths normalized like the folder loader's.
+// inotify on Linux, a last-write-time scan every poll_interval seconds everywhere else. The scan runs on a
+// worker so poll never walks the folders on the render thread.
+class asset_watcher {
+	std::vector<std::string> folders;
+#ifdef __linux__
+	int fd = -1;
+	std::unordered_map<int, std::string> watch_dirs; // watch descriptor -> directory
+	void add_watches(const std::string& folder);
+#else
+	std::unordered_map<std::string, std::filesystem::file_time_type> stamps;
+	Uint64 next_scan_ms = 0;
+	Uint64 interval_ms;
+	std::future<std::vector<std::string>> scanning; // stamps belongs to the worker while this is valid
+	std::vector<std::string> scan();
+#endif
+public:
+	explicit asset_watcher(const std::vector<std::string>& folders_in, double poll_interval = 0.25);
+	~asset_watcher();
+	asset_watcher(const asset_watcher&) = delete;
+	asset_watcher& operator=(const asset_watcher&) = delete;
+
+	void poll(std::vector<std::string>& changed); // non-blocking, appends each changed path once
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <memory>
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
+#include "transform_table.hpp"
 
 struct Camera {
 	float x = 0.f, y = 0.f;
@@ -44,11 +45,27 @@ struct Transform {
 	double worldX = 0.f, worldY = 0.f;
 	Transform* parent = nullptr;
 	bool dirty = true;
+	// node in a container's transform_table, which then owns worldX/Y; copies start unbound
+	transform_table* table = nullptr;
+	int node = -1;
 
-	void setLocal(double x, double y) { localX = x; localY = y; dirty = true; }
+	Transform() = default;
+	Transform(const Transform& rhs) : localX(rhs.localX), localY(rhs.localY), worldX(rhs.worldX), worldY(rhs.worldY), parent(rhs.parent) {}
+	Transform& operator=(const Transform& rhs) {
+		localX = rhs.localX; localY = rhs.localY;
+		worldX = rhs.worldX; worldY = rhs.worldY;
+		parent = rhs.parent;
+		setLocal(localX, localY);
+		return *this;
+	}
+
+	void setLocal(double x, double y) {
+		localX = x; localY = y; dirty = true;
+		if (table) table->set_local(node, x, y);
+	}
 	void setWorld(double x, double y) {
 		if (parent) { setLocal(x - parent->worldX, y - parent->worldY); }
-		else { localX = x; localY = y; dirty = true; }
+		else { setLocal(x, y); }
 	}
 
 	void markDirty() { dirty = true; }
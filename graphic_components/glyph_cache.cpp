@@ -0,0 +1,144 @@
+#include "glyph_cache.hpp"
+
+namespace {
+	// decodes one UTF-8 sequence, malformed bytes come back as '?'
+	Uint32 next_codepoint(const std::string& s, size_t& i) {
+		const unsigned char c = static_cast<unsigned char>(s[i++]);
+		if (c < 0x80) return c;
+		int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : -1;
+		if (extra < 0) return '?';
+		Uint32 cp = c & (0x3F >> extra);
+		while (extra-- > 0) {
+			if (i >= s.size() || (static_cast<unsigned char>(s[i]) & 0xC0) != 0x80) return '?';
+			cp = (cp << 6) | (static_cast<unsigned char>(s[i++]) & 0x3F);
+		}
+		return cp;
+	}
+
+	inline SDL_FColor to_fcolor(SDL_Color c) {
+		return SDL_FColor{ c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, c.a / 255.0f };
+	}
+}
+
+// GLYPH RUN
+
+void glyph_run::recolor(SDL_Color color) {
+	const SDL_FColor fc = to_fcolor(color);
+	for (SDL_Vertex& v : verts) v.color = fc;
+}
+
+// GLYPH ATLAS
+
+glyph_atlas::glyph_atlas(SDL_Renderer* renderer, TTF_Font* font, int page_size) : font(font), renderer(renderer), page_size(page_size) {}
+
+glyph_atlas::~glyph_atlas() {
+	if (page) SDL_DestroyTexture(page);
+}
+
+bool glyph_atlas::rasterize(Uint32 ch, glyph_info& out) {
+	int advance = 0;
+	TTF_GetGlyphMetrics(font, ch, nullptr, nullptr, nullptr, nullptr, &advance);
+	out.advance = static_cast<float>(advance);
+
+	SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, ch, SDL_Color{ 255,255,255,255 }); // tinted per vertex
+	if (!rendered || rendered->w == 0 || rendered->h == 0) {
+		if (rendered) SDL_DestroySurface(rendered);
+		return true; // nothing visible, advance only
+	}
+	SDL_Surface* g = SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32);
+	SDL_DestroySurface(rendered);
+	if (!g) {
+		SDL_Log("glyph convert failed: %s", SDL_GetError());
+		return false;
+	}
+
+	if (!page) {
+		page = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, page_size, page_size);
+		if (!page) {
+			SDL_Log("glyph page create failed: %s", SDL_GetError());
+			SDL_DestroySurface(g);
+			return false;
+		}
+		std::vector<Uint32> clear_px(static_cast<size_t>(page_size) * page_size, 0);
+		SDL_UpdateTexture(page, nullptr, clear_px.data(), page_size * 4);
+		SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+	}
+
+	const int pad = 1;
+	if (pen_x + g->w + pad > page_size) { // next row
+		pen_x = 0;
+		pen_y += row_h;
+		row_h = 0;
+	}
+	if (pen_y + g->h + pad > page_size) {
+		SDL_Log("glyph page full (%d px), glyph U+%04X skipped", page_size, static_cast<unsigned>(ch));
+		SDL_DestroySurface(g);
+		return false;
+	}
+
+	SDL_Rect dst{ pen_x, pen_y, g->w, g->h };
+	SDL_UpdateTexture(page, &dst, g->pixels, g->pitch);
+	out.src = { (float)dst.x, (float)dst.y, (float)dst.w, (float)dst.h };
+	pen_x += g->w + pad;
+	row_h = std::max(row_h, g->h + pad);
+	SDL_DestroySurface(g);
+	return true;
+}
+
+const glyph_info* glyph_atlas::get(Uint32 ch) {
+	if (auto it = glyphs.find(ch); it != glyphs.end()) return &it->second;
+	if (missing.count(ch)) return nullptr;
+	glyph_info info;
+	if (!rasterize(ch, info)) {
+		missing.insert(ch); // logged once, later layouts just skip it
+		return nullptr;
+	}
+	return &glyphs.emplace(ch, info).first->second;
+}
+
+bool glyph_atlas::layout(const std::string& text, SDL_Color color, glyph_run& out) {
+	out.verts.clear();
+	out.indices.clear();
+	out.w = out.h = 0;
+
+	const float line_h = static_cast<float>(TTF_GetFontLineSkip(font));
+	const SDL_FColor fc = to_fcolor(color);
+	float pen = 0, line_y = 0;
+	Uint32 prev = 0;
+
+	for (size_t i = 0; i < text.size();) {
+		const Uint32 ch = next_codepoint(text, i);
+		if (ch == '\n') {
+			out.w = std::max(out.w, pen);
+			pen = 0;
+			line_y += line_h;
+			prev = 0;
+			continue;
+		}
+		const glyph_info* g = get(ch);
+		if (!g) continue;
+
+		int kern = 0;
+		if (prev && TTF_GetGlyphKerning(font, prev, ch, &kern)) pen += static_cast<float>(kern);
+		prev = ch;
+
+		if (g->src.w > 0) {
+			const float u0 = g->src.x / page_size, v0 = g->src.y / page_size;
+			const float u1 = (g->src.x + g->src.w) / page_size, v1 = (g->src.y + g->src.h) / page_size;
+			const float x0 = pen, y0 = line_y, x1 = pen + g->src.w, y1 = line_y + g->src.h;
+			const int base = static_cast<int>(out.verts.size());
+			out.verts.push_back({ { x0, y0 }, fc, { u0, v0 } });
+			out.verts.push_back({ { x1, y0 }, fc, { u1, v0 } });
+			out.verts.push_back({ { x1, y1 }, fc, { u1, v1 } });
+			out.verts.push_back({ { x0, y1 }, fc, { u0, v1 } });
+			const int quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+			out.indices.insert(out.indices.end(), quad, quad + 6);
+			out.h = std::max(out.h, y1);
+		}
+		pen += g->advance;
+	}
+	out.w = std::max(out.w, pen);
+	out.h = std::max(out.h, line_y + line_h);
+	out.tex = page;
+	return true;
+}
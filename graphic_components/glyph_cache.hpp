@@ -0,0 +1,52 @@
+#pragma once
+#ifndef glyph_cache_hpp
+#define glyph_cache_hpp
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+struct glyph_info {
+	SDL_FRect src{ 0,0,0,0 }; // empty for glyphs with nothing to draw (space)
+	float advance = 0;
+};
+
+// laid out string: textured quads relative to the run's top-left corner
+struct glyph_run {
+	SDL_Texture* tex = nullptr;
+	std::vector<SDL_Vertex> verts; // 4 per glyph
+	std::vector<int> indices;      // 6 per glyph
+	float w = 0, h = 0;
+
+	void recolor(SDL_Color color);
+};
+
+// one page of rasterized glyphs for a single (font, size), filled on demand
+class glyph_atlas {
+	TTF_Font* font;
+	SDL_Renderer* renderer;
+	SDL_Texture* page = nullptr;
+	int page_size;
+	int pen_x = 0, pen_y = 0, row_h = 0;
+	std::unordered_map<Uint32, glyph_info> glyphs;
+	std::unordered_set<Uint32> missing; // failed to rasterize (page full), not retried
+
+	bool rasterize(Uint32 ch, glyph_info& out);
+public:
+	glyph_atlas(SDL_Renderer* renderer, TTF_Font* font, int page_size = 1024);
+	~glyph_atlas();
+	glyph_atlas(const glyph_atlas&) = delete;
+	glyph_atlas& operator=(const glyph_atlas&) = delete;
+
+	const glyph_info* get(Uint32 ch);
+	SDL_Texture* get_page() const { return page; }
+	size_t glyph_count() const { return glyphs.size(); }
+
+	bool layout(const std::string& text, SDL_Color color, glyph_run& out);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "render_batch.hpp"
+
+namespace {
+	inline SDL_FColor to_fcolor(SDL_Color c) {
+		return SDL_FColor{ c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, c.a / 255.0f };
+	}
+
+	void push_quad(std::vector<SDL_Vertex>& verts, std::vector<int>& indices, const SDL_FRect& dst, SDL_FColor color, float u0, float v0, float u1, float v1) {
+		const int base = static_cast<int>(verts.size());
+		verts.push_back({ { dst.x, dst.y }, color, { u0, v0 } });
+		verts.push_back({ { dst.x + dst.w, dst.y }, color, { u1, v0 } });
+		verts.push_back({ { dst.x + dst.w, dst.y + dst.h }, color, { u1, v1 } });
+		verts.push_back({ { dst.x, dst.y + dst.h }, color, { u0, v1 } });
+		const int quad[6] = { base, base + 1, base + 2, base, base + 2, base + 3 };
+		indices.insert(indices.end(), quad, quad + 6);
+	}
+}
+
+void render_batch::begin(SDL_Renderer* renderer) {
+	ren = renderer;
+	tex = nullptr;
+	verts.clear();
+	indices.clear();
+	frame = {};
+	view = { 0, 0, 0, 0 };
+	SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND); // untextured runs blend like SDL_RenderFillRect did
+}
+
+void render_batch::end() {
+	flush();
+	last = frame;
+}
+
+void render_batch::flush() {
+	if (indices.empty()) return;
+	if (!SDL_RenderGeometry(ren, tex, verts.data(), static_cast<int>(verts.size()), indices.data(), static_cast<int>(indices.size()))) {
+		SDL_Log("[SDL] RenderGeometry (batch) error: %s", SDL_GetError());
+		SDL_ClearError();
+	}
+	++frame.draw_calls;
+	verts.clear();
+	indices.clear();
+}
+
+void render_batch::quad(SDL_Texture* t, const SDL_FRect& src, const SDL_FRect& dst) {
+	if (!t || t->w <= 0 || t->h <= 0) return;
+	use(t);
+	const float tw = static_cast<float>(t->w), th = static_cast<float>(t->h);
+	push_quad(verts, indices, dst, SDL_FColor{ 1, 1, 1, 1 }, src.x / tw, src.y / th, (src.x + src.w) / tw, (src.y + src.h) / th);
+	++frame.quads;
+}
+
+void render_batch::fill(const SDL_FRect& dst, SDL_Color color) {
+	fill(&dst, 1, color);
+}
+
+void render_batch::fill(const SDL_FRect* rects, int count, SDL_Color color) {
+	use(nullptr);
+	const SDL_FColor fc = to_fcolor(color);
+	for (int i = 0; i < count; ++i) {
+		push_quad(verts, indices, rects[i], fc, 0, 0, 0, 0);
+	}
+	frame.quads += count;
+}
+
+void render_batch::geometry(SDL_Texture* t, const std::vector<SDL_Vertex>& v, const std::vector<int>& idx, float x, float y, float scale) {
+	if (!t || v.empty()) return;
+	use(t);
+	const int base = static_cast<int>(verts.size());
+	for (SDL_Vertex p : v) {
+		p.position.x = x + p.position.x * scale;
+		p.position.y = y + p.position.y * scale;
+		verts.push_back(p);
+	}
+	for (int i : idx) indices.push_back(base + i);
+	frame.quads += idx.size() / 6;
+}
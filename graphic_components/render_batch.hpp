@@ -0,0 +1,46 @@
+#pragma once
+#ifndef render_batch_hpp
+#define render_batch_hpp
+#include <iostream>
+#include <vector>
+#include <SDL3/SDL.h>
+
+struct render_batch_stats {
+	size_t draw_calls = 0; // SDL_RenderGeometry calls
+	size_t quads = 0;
+};
+
+// Collects quads in draw order and submits every run that shares a texture with one SDL_RenderGeometry.
+// Nothing is reordered, so overlaps come out the same as drawing one by one; atlas pages keep the runs long.
+class render_batch {
+	SDL_Renderer* ren = nullptr;
+	SDL_Texture* tex = nullptr; // texture of the pending run, nullptr = solid colour
+	std::vector<SDL_Vertex> verts;
+	std::vector<int> indices;
+	render_batch_stats frame, last;
+	SDL_FRect view{ 0, 0, 0, 0 }; // world rect being drawn, w <= 0 = no culling
+
+	void use(SDL_Texture* t) {
+		if (t != tex && !indices.empty()) flush();
+		tex = t;
+	}
+public:
+	void begin(SDL_Renderer* renderer);
+	void end(); // flushes, stats() then reports this frame
+	void flush();
+
+	void quad(SDL_Texture* t, const SDL_FRect& src, const SDL_FRect& dst);
+	void fill(const SDL_FRect& dst, SDL_Color color);
+	void fill(const SDL_FRect* rects, int count, SDL_Color color);
+	void geometry(SDL_Texture* t, const std::vector<SDL_Vertex>& v, const std::vector<int>& idx, float x, float y, float scale); // vertices relative to (x, y)
+
+	void set_view(const SDL_FRect& world_view) { view = world_view; } // reset by begin()
+	bool visible(const SDL_FRect& b) const {
+		return view.w <= 0 || !(b.x > view.x + view.w || b.x + b.w < view.x || b.y > view.y + view.h || b.y + b.h < view.y);
+	}
+
+	SDL_Renderer* renderer() const { return ren; }
+	const render_batch_stats& stats() const { return last; }
+};
+
+#endif
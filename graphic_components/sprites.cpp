@@ -1,29 +1,30 @@
 #include "sprites.hpp"
 
-sprite_component::sprite_component() : obj_tex(nullptr) {}
+sprite_component::sprite_component() : obj_tex(nullptr), region_src{ 0, 0, 0, 0 } {}
 
-sprite_component::sprite_component(const std::string& texture, const texture_manager& tex_mgr) {
-	obj_tex = tex_mgr.get_texture(texture);
+sprite_component::sprite_component(const std::string& texture, texture_manager& tex_mgr) {
+	tex_ref = tex_mgr.acquire(texture);
+	const texture_region& r = tex_ref.region();
+	obj_tex = r.tex;
+	region_src = r.src;
 	if (!obj_tex) { std::cerr << "sprite Texture not found for '" << texture << "'\n"; return; }
 }
 
-void sprite_component::set_tex(const std::string& texture, const texture_manager& tex_mgr) {
-	obj_tex = tex_mgr.get_texture(texture);
+void sprite_component::set_tex(const std::string& texture, texture_manager& tex_mgr) {
+	tex_ref = tex_mgr.acquire(texture);
+	const texture_region& r = tex_ref.region();
+	obj_tex = r.tex;
+	region_src = r.src;
 	if (!obj_tex) { std::cerr << "streched background Texture not found for '" << texture << "'\n"; return; }
 
 }
 
-void sprite_component::render(SDL_Renderer* ren, const SDL_FRect* src_rect, const SDL_FRect* dst_rect, const Camera& cam) const { // no camera movement
-	SDL_RenderTexture(ren, obj_tex, src_rect, dst_rect);
-}
-
-void sprite_component::render(SDL_Renderer* ren, const SDL_FRect* src_rect, const SDL_FRect* dst_rect, const Camera& cam, double scale) const {
-	SDL_FRect camDst = *dst_rect;
-	camDst.x -= cam.x;
-	camDst.y -= cam.y;
-	camDst.w *= scale;
-	camDst.h *= scale;
-	SDL_RenderTexture(ren, obj_tex, src_rect, &camDst);
+bool sprite_component::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	if (!tex_ref || tex_ref.name() != key) return false;
+	texture_region r = tex_mgr.get_region(key);
+	obj_tex = r.tex;
+	region_src = r.src;
+	return true;
 }
 
 strech_bg::strech_bg() {
@@ -31,21 +32,23 @@ strech_bg::strech_bg() {
 	screen = { 0, 0, 0, 0 };
 }
 
-strech_bg::strech_bg(const std::string& texture, const texture_manager& tex_mgr, int screen_w, int screen_h) {
+strech_bg::strech_bg(const std::string& texture, texture_manager& tex_mgr, int screen_w, int screen_h) {
 	set_tex(texture, tex_mgr);
-	float w, h;
-	SDL_GetTextureSize(get_tex(), &w, &h);
-	src_rect = { 0, 0, w, h };
+	src_rect = get_src_rect();
 	screen = { 0, 0, (float)screen_w, (float)screen_h };
 }
 
 void strech_bg::set_screen(int screen_w, int screen_h) {
-	float w, h;
-	SDL_GetTextureSize(get_tex(), &w, &h);
-	src_rect = { 0, 0, w, h };
+	src_rect = get_src_rect();
 	screen = { 0, 0, (float)screen_w, (float)screen_h };
 }
 
-void strech_bg::render(SDL_Renderer* ren, const Camera& cam) const {
-	sprite_component::render(ren, &src_rect, &screen, cam);
-}
\ No newline at end of file
+bool strech_bg::refresh_texture(const std::string& key, texture_manager& tex_mgr) {
+	if (!sprite_component::refresh_texture(key, tex_mgr)) return false;
+	src_rect = get_src_rect();
+	return true;
+}
+
+void strech_bg::draw(render_batch& batch) const {
+	batch.quad(get_tex(), src_rect, screen);
+}
@@ -5,18 +5,20 @@
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
 #include "texture_manager.hpp"
-#include "camera.hpp"
+#include "render_batch.hpp"
 
 class sprite_component {
 	SDL_Texture* obj_tex;
+	texture_ref tex_ref;
+	SDL_FRect region_src; // where the image sits inside obj_tex (whole texture unless atlased)
 public:
 	sprite_component();
-	sprite_component(const std::string& texture, const texture_manager& tex_mgr);
-	virtual void render(SDL_Renderer* ren, const SDL_FRect* src_rect, const SDL_FRect* dst_rect, const Camera& cam) const;
-	virtual void render(SDL_Renderer* ren, const SDL_FRect* src_rect, const SDL_FRect* dst_rect, const Camera& cam, double scale) const;
+	sprite_component(const std::string& texture, texture_manager& tex_mgr);
 	SDL_Texture* get_tex() { return obj_tex; }
-	void set_tex(const std::string& texture, const texture_manager& tex_mgr);
-	virtual ~sprite_component() {}
+	SDL_Texture* get_tex() const { return obj_tex; }
+	const SDL_FRect& get_src_rect() const { return region_src; }
+	void set_tex(const std::string& texture, texture_manager& tex_mgr);
+	bool refresh_texture(const std::string& key, texture_manager& tex_mgr); // true if this component uses key
 };
 
 class strech_bg :public sprite_component {
@@ -24,12 +26,12 @@ class strech_bg :public sprite_component {
 	SDL_FRect screen;
 public:
 	strech_bg();
-	strech_bg(const std::string& texture, const texture_manager& tex_mgr, int screen_w, int screen_h);
+	strech_bg(const std::string& texture, texture_manager& tex_mgr, int screen_w, int screen_h);
 	void set_screen(int screen_w, int screen_h);
-	void render(SDL_Renderer* ren, const Camera& cam) const;
+	void draw(render_batch& batch) const; // screen space
+	bool refresh_texture(const std::string& key, texture_manager& tex_mgr);
 	using sprite_component::get_tex;
 	using sprite_component::set_tex;
-	~strech_bg() {}
 };
 
 #endif
\ No newline at end of file
@@ -1,70 +1,93 @@
 ﻿#include "texture_manager.hpp"
-
-namespace fs = std::filesystem;
+#include <unordered_set>
+#include <cmath>
 
 texture_manager::texture_manager(SDL_Renderer* renderer) : renderer(renderer) {}
 
 texture_manager::~texture_manager() { clear(); }
 
 namespace {
-    inline std::string to_lower(std::string s) {
-        std::transform(s.begin(), s.end(), s.begin(),
-            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-        return s;
+    inline std::string_view last_segment(std::string_view key) {
+        const auto p = key.find_last_of('/');
+        return (p == std::string_view::npos) ? key : key.substr(p + 1);
     }
+}
 
-    inline std::string last_segment(const std::string& key) {
-        const auto p = key.find_last_of('/');
-        return (p == std::string::npos) ? key : key.substr(p + 1);
+// replacing an entry keeps its references, the holders see the new texture on their next lookup
+texture_manager::texture_entry& texture_manager::put_texture(const std::string& key, const texture_region& region, const std::string& source) {
+    auto [it, inserted] = textures.try_emplace(key);
+    texture_entry& e = it->second;
+    if (inserted) index_key(it->first);
+    else {
+        if (e.region.page < 0 && e.region.tex) memory_used -= e.bytes;
+        if (e.region.page >= 0) atlas_pages[e.region.page].refs -= e.refs;
     }
+
+    e.region = region;
+    e.source = source;
+    e.last_use = ++use_clock;
+    if (region.page >= 0) {
+        e.region.tex = nullptr; // resolved through the page, which may be reloaded
+        e.bytes = 0;
+        atlas_pages[region.page].refs += e.refs;
+    }
+    else {
+        e.bytes = texture_bytes(region.tex);
+        memory_used += e.bytes;
+    }
+    return e;
 }
 
-auto texture_manager::find_iter_by_name(const std::string& name) -> decltype(textures)::iterator{
-    auto it = textures.find(name);
-    if (it != textures.end()) return it;
-
-    if (name.find('/') == std::string::npos) {
-        decltype(textures)::iterator found = textures.end();
-        size_t hits = 0;
-        for (auto iter = textures.begin(); iter != textures.end(); ++iter) {
-            if (last_segment(iter->first) == name) {
-                found = iter;
-                ++hits;
-                if (hits > 1) break;
-            }
-        }
-        if (hits == 1) return found;
-        if (hits > 1) {
-            std::cerr << "Ambiguous texture name '" << name
-                      << "' matches multiple keys. Use full path like 'folder/" << name << "'.\n";
-        }
+auto texture_manager::erase_texture(decltype(textures)::iterator it) -> decltype(textures)::iterator {
+    const texture_entry& e = it->second;
+    if (e.region.page >= 0) atlas_pages[e.region.page].refs -= e.refs;
+    else if (e.region.tex) memory_used -= e.bytes;
+    unindex_key(it->first);
+    return textures.erase(it);
+}
+
+// keys without '/' are reachable by exact lookup, only folder keys need the basename index
+void texture_manager::index_key(const std::string& key) {
+    if (key.find('/') == std::string::npos) return;
+    auto& keys = basename_index[std::string(last_segment(key))];
+    keys.push_back(key);
+    if (keys.size() == 2) {
+        std::cerr << "Ambiguous texture name '" << last_segment(key)
+                  << "' matches multiple keys. Use full path like 'folder/" << last_segment(key) << "'.\n";
     }
-    return textures.end();
+}
+
+void texture_manager::unindex_key(const std::string& key) {
+    if (key.find('/') == std::string::npos) return;
+    auto it = basename_index.find(last_segment(key));
+    if (it == basename_index.end()) return;
+    auto& keys = it->second;
+    keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+    if (keys.empty()) basename_index.erase(it);
+}
+
+auto texture_manager::find_iter_by_name(std::string_view name) -> decltype(textures)::iterator {
+    auto it = textures.find(name);
+    if (it != textures.end() || name.find('/') != std::string_view::npos) return it;
+
+    auto bi = basename_index.find(name);
+    if (bi == basename_index.end() || bi->second.size() != 1) return textures.end(); // missing or ambiguous
+    return textures.find(bi->second.front());
 }
 
 //const version
-auto texture_manager::find_iter_by_name(const std::string& name) const -> decltype(textures)::const_iterator{
+auto texture_manager::find_iter_by_name(std::string_view name) const -> decltype(textures)::const_iterator {
     auto it = textures.find(name);
-    if (it != textures.end()) return it;
-
-    if (name.find('/') == std::string::npos) {
-        decltype(textures)::const_iterator found = textures.end();
-        size_t hits = 0;
-        for (auto iter = textures.cbegin(); iter != textures.cend(); ++iter) {
-            if (last_segment(iter->first) == name) {
-                found = iter;
-                ++hits;
-                if (hits > 1) break;
-            }
-        }
-        return (hits == 1) ? found : textures.end();
-    }
-    return textures.end();
+    if (it != textures.end() || name.find('/') != std::string_view::npos) return it;
+
+    auto bi = basename_index.find(name);
+    if (bi == basename_index.end() || bi->second.size() != 1) return textures.end();
+    return textures.find(bi->second.front());
 }
 
 SDL_Texture* texture_manager::load_texture(const std::string& name, const std::string& filename) {
-    if (textures.find(name) != textures.end()) {
-        return textures[name];
+    if (auto it = textures.find(name); it != textures.end()) {
+        return make_resident(it->second) ? resident_region(it->second).tex : nullptr;
     }
 
     SDL_Surface* surface = IMG_Load(filename.c_str());
@@ -74,6 +97,7 @@ SDL_Texture* texture_manager::load_texture(const std::string& name, const std::s
     }
 
     SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    const float w = static_cast<float>(surface->w), h = static_cast<float>(surface->h);
     SDL_DestroySurface(surface);
 
     if (!texture) {
@@ -82,106 +106,734 @@ SDL_Texture* texture_manager::load_texture(const std::string& name, const std::s
         return nullptr;
     }
 
-    textures[name] = texture;
+    const texture_entry& e = put_texture(name, { texture, { 0, 0, w, h }, -1 }, filename);
+    enforce_budget(&e);
     return texture;
 }
 
-SDL_Texture* texture_manager::get_texture(const std::string& name) const {
-    auto it = textures.find(name);
-    return (it != textures.end()) ? it->second : nullptr;
+SDL_Texture* texture_manager::get_texture(std::string_view name) {
+    auto it = find_iter_by_name(name);
+    if (it == textures.end() || !make_resident(it->second)) return nullptr;
+    return resident_region(it->second).tex;
+}
+
+texture_region texture_manager::get_region(std::string_view name) {
+    auto it = find_iter_by_name(name);
+    if (it == textures.end() || !make_resident(it->second)) return {};
+    return resident_region(it->second);
+}
+
+texture_ref texture_manager::acquire(std::string_view name) {
+    auto it = find_iter_by_name(name);
+    if (it == textures.end() || !make_resident(it->second)) return {};
+    retain(it->first);
+    return texture_ref(this, it->first, resident_region(it->second));
+}
+
+void texture_manager::retain(const std::string& key) {
+    auto it = textures.find(key);
+    if (it == textures.end()) return;
+    ++it->second.refs;
+    if (it->second.region.page >= 0) ++atlas_pages[it->second.region.page].refs;
+}
+
+void texture_manager::release(const std::string& key) {
+    auto it = textures.find(key);
+    if (it == textures.end() || it->second.refs == 0) return; // unloaded or cleared while referenced
+    --it->second.refs;
+    if (it->second.region.page >= 0) --atlas_pages[it->second.region.page].refs;
+    if (it->second.refs == 0) enforce_budget();
+}
+
+// MEMORY BUDGET
+
+size_t texture_manager::texture_bytes(SDL_Texture* tex) {
+    if (!tex) return 0;
+    const int bpp = SDL_BYTESPERPIXEL(tex->format);
+    return static_cast<size_t>(tex->w) * tex->h * (bpp > 0 ? bpp : 4);
+}
+
+texture_region texture_manager::resident_region(const texture_entry& e) const {
+    texture_region r = e.region;
+    if (r.page >= 0) r.tex = atlas_pages[r.page].tex;
+    return r;
+}
+
+bool texture_manager::make_resident(texture_entry& e) {
+    e.last_use = ++use_clock;
+    if (e.region.page >= 0) {
+        atlas_page& pg = atlas_pages[e.region.page];
+        pg.last_use = e.last_use;
+        return pg.tex || reload_page(e.region.page);
+    }
+    if (e.region.tex) return true;
+    if (e.source.empty()) return false;
+
+    SDL_Surface* surf = decode_image(e.source);
+    if (!surf) return false;
+    SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
+    SDL_DestroySurface(surf);
+    if (!tex) {
+        std::cerr << "Failed to reload texture from: " << e.source << "\n";
+        return false;
+    }
+    e.region.tex = tex;
+    e.bytes = texture_bytes(tex);
+    memory_used += e.bytes;
+    ++reload_count;
+    enforce_budget(&e);
+    return true;
+}
+
+bool texture_manager::reload_page(int page) {
+    atlas_page& pg = atlas_pages[page];
+    if (pg.pack_page >= 0) {
+        if (!upload_pack_page(pg)) return false;
+        ++reload_count;
+        enforce_budget(nullptr, page);
+        return true;
+    }
+
+    SDL_Surface* sheet = SDL_CreateSurface(pg.w, pg.h, SDL_PIXELFORMAT_RGBA32);
+    if (!sheet) {
+        SDL_Log("SDL_CreateSurface failed: %s", SDL_GetError());
+        return false;
+    }
+    SDL_FillSurfaceRect(sheet, nullptr, SDL_MapSurfaceRGBA(sheet, 0, 0, 0, 0));
+    for (auto& [path, slot] : pg.files) {
+        SDL_Surface* surf = decode_image(path);
+        if (!surf) continue;
+        SDL_SetSurfaceBlendMode(surf, SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(surf, nullptr, sheet, &slot);
+        SDL_DestroySurface(surf);
+    }
+
+    pg.tex = SDL_CreateTextureFromSurface(renderer, sheet);
+    SDL_DestroySurface(sheet);
+    if (!pg.tex) {
+        SDL_Log("CreateTextureFromSurface failed (atlas page reload): %s", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureBlendMode(pg.tex, SDL_BLENDMODE_BLEND);
+    pg.bytes = texture_bytes(pg.tex);
+    memory_used += pg.bytes;
+    ++reload_count;
+    enforce_budget(nullptr, page);
+    return true;
+}
+
+// Evicts unreferenced, reloadable textures and pages, oldest use first, until the budget fits.
+// keep / keep_page was just handed out and must survive this pass.
+void texture_manager::enforce_budget(const texture_entry* keep, int keep_page) {
+    if (memory_budget == 0 || memory_used <= memory_budget) return;
+
+    struct candidate {
+        Uint64 last_use;
+        texture_entry* entry; // nullptr for a page
+        int page;
+    };
+    std::vector<candidate> lru;
+    for (auto& [key, e] : textures) {
+        if (e.region.page < 0 && e.region.tex && e.refs == 0 && !e.source.empty() && &e != keep) {
+            lru.push_back({ e.last_use, &e, -1 });
+        }
+    }
+    for (int p = 0; p < static_cast<int>(atlas_pages.size()); ++p) {
+        const atlas_page& pg = atlas_pages[p];
+        if (pg.tex && pg.refs == 0 && p != keep_page && (!keep || keep->region.page != p)) {
+            lru.push_back({ pg.last_use, nullptr, p });
+        }
+    }
+    std::sort(lru.begin(), lru.end(), [](const candidate& a, const candidate& b) { return a.last_use < b.last_use; });
+
+    for (const candidate& c : lru) {
+        if (memory_used <= memory_budget) break;
+        if (c.entry) {
+            SDL_DestroyTexture(c.entry->region.tex);
+            c.entry->region.tex = nullptr;
+            memory_used -= c.entry->bytes;
+        }
+        else {
+            atlas_page& pg = atlas_pages[c.page];
+            SDL_DestroyTexture(pg.tex);
+            pg.tex = nullptr;
+            memory_used -= pg.bytes;
+        }
+        ++eviction_count;
+    }
+}
+
+void texture_manager::collect_image_files(const std::string& folder_path, std::vector<decoded_image>& out) {
+    std::unordered_set<std::string> queued_paths;
+    for (const auto& o : out) queued_paths.insert(o.path);
+
+    std::vector<image_file> files;
+    list_image_files(folder_path, files);
+    for (auto& f : files) {
+        if (textures.find(f.key) != textures.end()) continue;
+
+        decoded_image img;
+        img.key = std::move(f.key);
+        img.path = std::move(f.path);
+        if (atlas_mode) {
+            // same file through another folder: share the packed region instead of decoding it again
+            img.alias = atlas_files.count(img.path) != 0 || queued_paths.count(img.path) != 0;
+        }
+        queued_paths.insert(img.path);
+        out.push_back(std::move(img));
+    }
+}
+
+// safe to call from worker threads, touches nothing but the file and the new surface
+SDL_Surface* texture_manager::decode_image(const std::string& path) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (!loaded) {
+        std::cerr << "Failed to load image: " << path << "\n";
+        return nullptr;
+    }
+    if (loaded->format == SDL_PIXELFORMAT_RGBA32) return loaded;
+
+    SDL_Surface* surf = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(loaded);
+    if (!surf) {
+        std::cerr << "Failed to convert image: " << path << "\n";
+    }
+    return surf;
 }
 
 void texture_manager::load_textures_from_folder(const std::string& folder_path) {
-    const fs::path base = folder_path;
+    std::vector<decoded_image> images;
+    collect_image_files(folder_path, images);
+    for (auto& img : images) {
+        if (!img.alias) img.surf = decode_image(img.path);
+    }
+    upload_decoded(images);
+}
+
+void texture_manager::begin_async_load(const std::vector<std::string>& folder_paths, unsigned thread_count) {
+    finish_async_load(); // one batch at a time
+
+    for (const auto& folder : folder_paths) {
+        collect_image_files(folder, pending_images);
+    }
+    decode_next = 0;
+    decode_done = 0;
+    if (pending_images.empty()) return;
 
-    std::error_code ec;
-    for (fs::recursive_directory_iterator it(base, ec), end; it != end; it.increment(ec)) {
-        if (ec) {
-            std::cerr << "Filesystem iteration error: " << ec.message() << "\n";
-            break;
+    if (thread_count == 0) {
+        const unsigned hw = std::thread::hardware_concurrency();
+        thread_count = hw > 1 ? hw - 1 : 1; // leave a core for the main thread
+    }
+    thread_count = std::min<unsigned>(thread_count, static_cast<unsigned>(pending_images.size()));
+
+    for (unsigned i = 0; i < thread_count; ++i) {
+        decode_workers.emplace_back([this] {
+            for (size_t idx = decode_next++; idx < pending_images.size(); idx = decode_next++) {
+                decoded_image& img = pending_images[idx];
+                if (!img.alias) img.surf = decode_image(img.path);
+                ++decode_done;
+            }
+        });
+    }
+}
+
+float texture_manager::async_progress() const {
+    if (pending_images.empty()) return 1.0f;
+    return static_cast<float>(decode_done.load()) / static_cast<float>(pending_images.size());
+}
+
+bool texture_manager::async_ready() const {
+    return decode_done.load() >= pending_images.size();
+}
+
+bool texture_manager::finish_async_load() {
+    if (pending_images.empty() && decode_workers.empty()) return false;
+    for (auto& t : decode_workers) t.join();
+    decode_workers.clear();
+
+    std::vector<decoded_image> images = std::move(pending_images);
+    pending_images.clear();
+    upload_decoded(images);
+    return true;
+}
+
+void texture_manager::drop_async_load() {
+    decode_next = pending_images.size(); // workers stop picking up files
+    for (auto& t : decode_workers) t.join();
+    decode_workers.clear();
+    for (auto& img : pending_images) {
+        if (img.surf) SDL_DestroySurface(img.surf);
+    }
+    pending_images.clear();
+}
+
+// render thread only: turns decoded surfaces into textures and frees them
+void texture_manager::upload_decoded(std::vector<decoded_image>& images) {
+    if (atlas_mode) {
+        pack_atlas(images);
+    }
+    else {
+        for (auto& img : images) {
+            if (!img.surf || textures.find(img.key) != textures.end()) continue;
+            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, img.surf);
+            if (!tex) {
+                std::cerr << "Failed to create texture from: " << img.path << "\n";
+                std::cerr << "SDL error: " << SDL_GetError() << "\n";
+                continue;
+            }
+            put_texture(img.key, { tex, { 0, 0, (float)img.surf->w, (float)img.surf->h }, -1 }, img.path);
+        }
+    }
+    for (auto& img : images) {
+        if (img.surf) SDL_DestroySurface(img.surf);
+        img.surf = nullptr;
+    }
+    enforce_budget();
+}
+
+// Shelf-packs the images into as few pages as possible (tallest first).
+// Images that don't fit a page on their own stay standalone textures.
+void texture_manager::pack_atlas(std::vector<decoded_image>& images) {
+    struct pending {
+        decoded_image* img;
+        SDL_Rect slot;
+        int page;
+    };
+    std::vector<pending> items;
+    items.reserve(images.size());
+
+    int page_size = atlas_page_size;
+    const Sint64 max_size = SDL_GetNumberProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_MAX_TEXTURE_SIZE_NUMBER, 0);
+    if (max_size > 0 && max_size < page_size) page_size = static_cast<int>(max_size);
+    const int pad = atlas_padding;
+
+    for (auto& img : images) {
+        if (!img.surf || textures.find(img.key) != textures.end()) continue;
+        SDL_Surface* surf = img.surf;
+
+        if (surf->w + 2 * pad > page_size || surf->h + 2 * pad > page_size) {
+            SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surf);
+            if (!tex) {
+                std::cerr << "Failed to create texture from: " << img.path << "\n";
+                continue;
+            }
+            put_texture(img.key, { tex, { 0, 0, (float)surf->w, (float)surf->h }, -1 }, img.path);
+            continue;
         }
+        items.push_back({ &img, { 0, 0, surf->w, surf->h }, -1 });
+    }
 
-        const fs::directory_entry& entry = *it;
-        if (!entry.is_regular_file()) continue;
+    std::vector<SDL_Rect> slots;
+    slots.reserve(items.size());
+    for (const auto& it : items) slots.push_back(it.slot);
+    std::vector<int> page_of;
+    const std::vector<SDL_Point> extents = shelf_pack(slots, page_of, page_size, pad); // used size of every new page
+    for (size_t i = 0; i < items.size(); ++i) {
+        items[i].slot = slots[i];
+        items[i].page = page_of[i];
+    }
 
-        const fs::path& p = entry.path();
-        std::string ext = to_lower(p.extension().string());
-        if (ext != ".png" && ext != ".jpg" && ext != ".jpeg") continue;
+    const size_t first_page = atlas_pages.size();
+    for (int p = 0; p < static_cast<int>(extents.size()); ++p) {
+        SDL_Surface* sheet = SDL_CreateSurface(extents[p].x, extents[p].y, SDL_PIXELFORMAT_RGBA32);
+        if (!sheet) {
+            SDL_Log("SDL_CreateSurface failed: %s", SDL_GetError());
+            continue;
+        }
+        SDL_FillSurfaceRect(sheet, nullptr, SDL_MapSurfaceRGBA(sheet, 0, 0, 0, 0));
+        for (auto& it : items) {
+            if (it.page != p) continue;
+            SDL_SetSurfaceBlendMode(it.img->surf, SDL_BLENDMODE_NONE); // copy alpha as-is
+            SDL_BlitSurface(it.img->surf, nullptr, sheet, &it.slot);
+        }
 
-        // key = relative_dir / stem  (no extension), using '/' separators
-        std::error_code ec2;
-        fs::path rel_dir = fs::relative(p.parent_path(), base, ec2);
-        if (ec2) rel_dir.clear();
+        SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, sheet);
+        SDL_DestroySurface(sheet);
+        if (!tex) {
+            SDL_Log("CreateTextureFromSurface failed (atlas page): %s", SDL_GetError());
+            continue;
+        }
+        SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        atlas_page& pg = atlas_pages.emplace_back();
+        pg.tex = tex;
+        pg.w = extents[p].x;
+        pg.h = extents[p].y;
+        pg.bytes = texture_bytes(tex);
+        pg.last_use = ++use_clock;
+        memory_used += pg.bytes;
 
-        fs::path key_path = (rel_dir.empty() || rel_dir == ".") ? p.stem() : (rel_dir / p.stem());
-        std::string key = key_path.generic_string(); // '/' on all platforms
+        const int page_idx = static_cast<int>(atlas_pages.size()) - 1;
+        for (auto& it : items) {
+            if (it.page != p) continue;
+            texture_region r{ tex, { (float)it.slot.x, (float)it.slot.y, (float)it.slot.w, (float)it.slot.h }, page_idx };
+            put_texture(it.img->key, r, it.img->path);
+            atlas_files[it.img->path] = r;
+            atlas_pages[page_idx].files.emplace_back(it.img->path, it.slot);
+        }
+    }
 
-        load_texture(key, p.string());
+    for (auto& img : images) {
+        if (!img.alias || textures.find(img.key) != textures.end()) continue;
+        if (auto it = atlas_files.find(img.path); it != atlas_files.end()) {
+            put_texture(img.key, it->second, img.path);
+        }
     }
+
+    if (!items.empty()) {
+        std::cout << "atlas: packed " << items.size() << " images into " << (atlas_pages.size() - first_page) << " page(s)" << std::endl;
+    }
+}
+
+// PACK
+
+bool texture_manager::open_pack(const std::string& path, const std::vector<std::string>& source_folders) {
+    if (!pack.open(path)) return false;
+    if (!pack.matches(source_folders)) {
+        std::cerr << "Asset pack is older than the images in the asset folders, ignoring " << path << " (rebuild it with --pack)\n";
+        pack.close();
+        return false;
+    }
+    return true;
+}
+
+// no decode and no staging copy: the texture is filled straight from the mapped blob
+bool texture_manager::upload_pack_page(atlas_page& pg) {
+    const pack_page& src = pack.page(static_cast<Uint32>(pg.pack_page));
+    pg.tex = SDL_CreateTexture(renderer, static_cast<SDL_PixelFormat>(pack.header().pixel_format), SDL_TEXTUREACCESS_STATIC, pg.w, pg.h);
+    if (!pg.tex) {
+        SDL_Log("SDL_CreateTexture failed (pack page): %s", SDL_GetError());
+        return false;
+    }
+    if (!SDL_UpdateTexture(pg.tex, nullptr, pack.pixels(src), static_cast<int>(src.pitch))) {
+        SDL_Log("SDL_UpdateTexture failed (pack page): %s", SDL_GetError());
+        SDL_DestroyTexture(pg.tex);
+        pg.tex = nullptr;
+        return false;
+    }
+    SDL_SetTextureBlendMode(pg.tex, SDL_BLENDMODE_BLEND);
+    pg.bytes = texture_bytes(pg.tex);
+    memory_used += pg.bytes;
+    pg.last_use = ++use_clock;
+    return true;
+}
+
+bool texture_manager::upload_pack() {
+    if (!pack.is_open()) return false;
+    const pack_header& h = pack.header();
+    const int first_page = static_cast<int>(atlas_pages.size());
+
+    for (Uint32 i = 0; i < h.page_count; ++i) {
+        const pack_page& src = pack.page(i);
+        atlas_page& pg = atlas_pages.emplace_back();
+        pg.w = static_cast<int>(src.w);
+        pg.h = static_cast<int>(src.h);
+        pg.pack_page = static_cast<int>(i);
+        if (!upload_pack_page(pg)) {
+            for (int p = first_page; p < static_cast<int>(atlas_pages.size()); ++p) {
+                if (atlas_pages[p].tex) {
+                    SDL_DestroyTexture(atlas_pages[p].tex);
+                    memory_used -= atlas_pages[p].bytes;
+                }
+            }
+            atlas_pages.resize(first_page);
+            return false;
+        }
+    }
+
+    for (Uint32 i = 0; i < h.image_count; ++i) {
+        const pack_image& img = pack.image(i);
+        const std::string key(pack.key(img));
+        if (textures.find(key) != textures.end()) continue;
+        put_texture(key, { nullptr, { (float)img.x, (float)img.y, (float)img.w, (float)img.h }, first_page + img.page });
+    }
+    std::cout << "pack: " << h.image_count << " images on " << h.page_count << " page(s)" << std::endl;
+    enforce_budget();
+    return true;
+}
+
+// HOT RELOAD
+
+void texture_manager::enable_hot_reload(const std::vector<std::string>& folders, double budget_ms) {
+    watcher = std::make_unique<asset_watcher>(folders);
+    reload_budget_ms = budget_ms;
+}
+
+void texture_manager::disable_hot_reload() {
+    for (auto& r : reloads) {
+        if (!r.image && r.surf.valid()) r.image = r.surf.get();
+        drop_reload(r);
+    }
+    reloads.clear();
+    changed_paths.clear();
+    watcher.reset();
+}
+
+size_t texture_manager::update_hot_reload(std::vector<std::string>& changed_keys) {
+    if (!watcher) return 0;
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const double budget_ticks = reload_budget_ms * 0.001 * static_cast<double>(SDL_GetPerformanceFrequency());
+    auto over_budget = [&] { return static_cast<double>(SDL_GetPerformanceCounter() - start) > budget_ticks; };
+
+    watcher->poll(changed_paths);
+    for (auto& path : changed_paths) {
+        const bool queued = std::any_of(reloads.begin(), reloads.end(), [&](const pending_reload& r) { return r.path == path && !r.image; });
+        if (!queued) reloads.push_back({ path, std::async(std::launch::async, decode_image, path) });
+    }
+    changed_paths.clear();
+
+    // upload what finished decoding one band at a time until the frame budget runs out, the rest waits for the next frame
+    const size_t before = changed_keys.size();
+    for (auto it = reloads.begin(); it != reloads.end() && !over_budget();) {
+        if (!it->image) {
+            if (it->surf.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+            it->image = it->surf.get();
+            if (!it->image) { // a half-written file fails to decode, its final write triggers another reload
+                it = reloads.erase(it);
+                continue;
+            }
+            plan_reload(*it);
+        }
+        bool done = false;
+        while (!(done = upload_reload_band(*it)) && !over_budget()) {}
+        if (!done) break; // out of budget mid-image, it carries on next frame
+        finish_reload(*it, changed_keys);
+        it = reloads.erase(it);
+    }
+    return changed_keys.size() - before;
+}
+
+// Same-size atlas entries are rewritten inside their page, anything else gets a new standalone texture with the new size.
+void texture_manager::plan_reload(pending_reload& r) {
+    const SDL_Surface* surf = r.image;
+    for (auto& [key, e] : textures) {
+        if (e.source != r.path) continue;
+        if (e.region.page >= 0) {
+            const SDL_Rect slot{ (int)e.region.src.x, (int)e.region.src.y, (int)e.region.src.w, (int)e.region.src.h };
+            if (slot.w == surf->w && slot.h == surf->h) {
+                const bool listed = std::any_of(r.targets.begin(), r.targets.end(), [&](const reload_target& t) { return t.page == e.region.page; });
+                if (!listed) r.targets.push_back({ e.region.page, nullptr, {}, slot });
+                continue;
+            }
+        }
+        SDL_Texture* tex = SDL_CreateTexture(renderer, surf->format, SDL_TEXTUREACCESS_STATIC, surf->w, surf->h);
+        if (!tex) {
+            std::cerr << "Failed to create texture for: " << r.path << "\n";
+            continue;
+        }
+        SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        r.targets.push_back({ -1, tex, key, { 0, 0, surf->w, surf->h } });
+    }
+}
+
+bool texture_manager::upload_reload_band(pending_reload& r) {
+    if (r.target >= r.targets.size()) return true;
+    const reload_target& t = r.targets[r.target];
+    const SDL_Surface* surf = r.image;
+    const int rows = std::max(1, std::min(surf->h - r.row, static_cast<int>(reload_band_bytes / std::max(1, surf->pitch))));
+    const Uint8* src = static_cast<const Uint8*>(surf->pixels) + static_cast<size_t>(r.row) * surf->pitch;
+    const SDL_Rect band{ t.dst.x, t.dst.y + r.row, t.dst.w, rows };
+
+    SDL_Texture* tex = t.page >= 0 ? atlas_pages[t.page].tex : t.tex;
+    if (tex) { // an evicted page reloads from the new file anyway
+        if (tex->format == surf->format) {
+            SDL_UpdateTexture(tex, &band, src, surf->pitch);
+        }
+        else {
+            const int pitch = band.w * SDL_BYTESPERPIXEL(tex->format);
+            reload_scratch.resize(static_cast<size_t>(pitch) * rows);
+            if (SDL_ConvertPixels(band.w, rows, surf->format, src, surf->pitch, tex->format, reload_scratch.data(), pitch)) {
+                SDL_UpdateTexture(tex, &band, reload_scratch.data(), pitch);
+            }
+        }
+    }
+    r.row += rows;
+    if (r.row >= surf->h) {
+        r.row = 0;
+        ++r.target;
+    }
+    return r.target >= r.targets.size();
+}
+
+void texture_manager::finish_reload(pending_reload& r, std::vector<std::string>& changed_keys) {
+    for (auto& [key, e] : textures) {
+        if (e.source != r.path) continue;
+        if (e.region.page >= 0 && (int)e.region.src.w == r.image->w && (int)e.region.src.h == r.image->h) changed_keys.push_back(key); // rewritten in place
+    }
+    for (auto& t : r.targets) {
+        if (t.page >= 0) continue;
+        auto it = textures.find(t.key);
+        if (it == textures.end() || it->second.source != r.path) { // unloaded while uploading
+            SDL_DestroyTexture(t.tex);
+            continue;
+        }
+        texture_entry& e = it->second;
+        if (e.region.page >= 0) {
+            atlas_page& pg = atlas_pages[e.region.page];
+            pg.files.erase(std::remove_if(pg.files.begin(), pg.files.end(),
+                [&](const auto& f) { return f.first == r.path; }), pg.files.end());
+        }
+        else if (e.region.tex) SDL_DestroyTexture(e.region.tex);
+        put_texture(t.key, { t.tex, { 0, 0, (float)r.image->w, (float)r.image->h }, -1 }, r.path);
+        changed_keys.push_back(t.key);
+    }
+    r.targets.clear();
+    SDL_DestroySurface(r.image);
+    r.image = nullptr;
+    atlas_files.erase(r.path); // later folder loads decode it again instead of aliasing a stale slot
+    std::cout << "hot reload: " << r.path << std::endl;
+}
+
+void texture_manager::drop_reload(pending_reload& r) {
+    for (const auto& t : r.targets) {
+        if (t.page < 0 && t.tex) SDL_DestroyTexture(t.tex);
+    }
+    r.targets.clear();
+    if (r.image) SDL_DestroySurface(r.image);
+    r.image = nullptr;
 }
 
-void texture_manager::unload_texture(const std::string& name) {
+void texture_manager::unload_texture(std::string_view name) {
     auto it = textures.find(name);
     if (it != textures.end()) {
-        SDL_DestroyTexture(it->second);
-        textures.erase(it);
+        if (it->second.region.page < 0 && it->second.region.tex) SDL_DestroyTexture(it->second.region.tex); // atlas pages are freed in clear()
+        erase_texture(it);
     }
 }
 
-bool texture_manager::has(const string& name) {
+bool texture_manager::has(std::string_view name) const {
     return textures.find(name) != textures.end();
 }
 
 void texture_manager::clear() {
-    for (auto& [name, texture] : textures) {
-        SDL_DestroyTexture(texture);
+    drop_async_load();
+    disable_hot_reload();
+    for (auto& [name, e] : textures) {
+        if (e.region.page < 0 && e.region.tex) SDL_DestroyTexture(e.region.tex);
     }
     textures.clear();
+    basename_index.clear();
+    for (atlas_page& page : atlas_pages) {
+        if (page.tex) SDL_DestroyTexture(page.tex);
+    }
+    atlas_pages.clear();
+    pack.close();
+    memory_used = 0;
+    atlas_files.clear();
     text_meta.clear();
+    glyph_atlases.clear();
 
     for (auto& [key, font] : fonts) {
         TTF_CloseFont(font);
     }
     fonts.clear();
+    for (font_file& file : font_files) { // after the fonts reading from them
+        SDL_free(file.data);
+    }
+    font_files.clear();
+    font_family_ids.clear();
+}
+
+// family id in the high half, size in 1/100 pt in the low half (same resolution the old "@%.2f" keys had)
+Uint64 texture_manager::font_key(Uint32 family_id, float pt) {
+    return (static_cast<Uint64>(family_id) << 32) | static_cast<Uint32>(std::lround(pt * 100.0f));
 }
 
-std::string texture_manager::font_key(const std::string& family, float pt) {
-    char buf[64]; SDL_snprintf(buf, sizeof(buf), "@%.2f", pt);
-    return family + buf;
+Uint32 texture_manager::font_family_id(const std::string& family) {
+    if (auto it = font_family_ids.find(family); it != font_family_ids.end()) return it->second;
+    const Uint32 id = static_cast<Uint32>(font_files.size());
+    font_files.push_back({ family, nullptr, 0 });
+    font_family_ids.emplace(family, id);
+    return id;
+}
+
+// whole file read once per family, every size parses from the same bytes
+const texture_manager::font_file* texture_manager::get_font_file(Uint32 family_id) {
+    font_file& file = font_files[family_id];
+    if (file.data) return &file;
+    file.data = SDL_LoadFile(file.path.c_str(), &file.size);
+    if (!file.data) {
+        SDL_Log("SDL_LoadFile failed (%s): %s", file.path.c_str(), SDL_GetError());
+        return nullptr;
+    }
+    ++font_stat.file_reads;
+    return &file;
 }
 
 TTF_Font* texture_manager::get_or_load_font(const std::string& family, float pt) {
-    auto key = font_key(family, pt);
-    if (auto it = fonts.find(key); it != fonts.end()) return it->second;
+    if (auto id = font_family_ids.find(family); id != font_family_ids.end()) {
+        if (auto it = fonts.find(font_key(id->second, pt)); it != fonts.end()) return it->second;
+    }
     return load_font(family, pt);
 }
 
 TTF_Font* texture_manager::load_font(const std::string& family, float pt) {
-    auto key = font_key(family, pt);
-    if (fonts.count(key)) return fonts[key];
+    const Uint32 id = font_family_id(family);
+    const Uint64 key = font_key(id, pt);
+    if (auto it = fonts.find(key); it != fonts.end()) return it->second;
 
-    TTF_Font* f = TTF_OpenFont(family.c_str(), pt);
+    const font_file* file = get_font_file(id);
+    if (!file) return nullptr;
+    SDL_IOStream* io = SDL_IOFromConstMem(file->data, file->size);
+    TTF_Font* f = io ? TTF_OpenFontIO(io, true, pt) : nullptr; // closes only the stream, the bytes stay in font_files
     if (!f) {
         SDL_Log("TTF_OpenFont failed (%s @ %.2fpt): %s", family.c_str(), pt, SDL_GetError());
         return nullptr;
     }
-    fonts[key] = f;
+    ++font_stat.opens;
+    fonts.emplace(key, f);
     return f;
 }
 
-void texture_manager::unload_font(const std::string& family, float pt) {
-    auto key = font_key(family, pt);
-    if (auto it = fonts.find(key); it != fonts.end()) {
-        TTF_CloseFont(it->second);
-        fonts.erase(it);
+bool texture_manager::unload_font(const std::string& family, float pt) {
+    auto id = font_family_ids.find(family);
+    if (id == font_family_ids.end()) return false;
+    auto it = fonts.find(font_key(id->second, pt));
+    if (it == fonts.end()) return false;
+    // glyph runs point into the font's atlas page, it has to outlive them
+    for (const auto& [name, e] : text_meta) {
+        if (e.glyph_mode && e.family == family && e.ptsize == pt) {
+            SDL_Log("unload_font: '%s' %.1fpt still drawn by glyph text '%s', kept", family.c_str(), pt, name.c_str());
+            return false;
+        }
     }
+    glyph_atlases.erase(it->second);
+    TTF_CloseFont(it->second);
+    fonts.erase(it);
+    return true;
 }
 bool texture_manager::has_font(const std::string& family, float pt) const {
-    return fonts.count(font_key(family, pt)) != 0;
+    auto id = font_family_ids.find(family);
+    return id != font_family_ids.end() && fonts.count(font_key(id->second, pt)) != 0;
+}
+
+glyph_atlas* texture_manager::get_glyph_atlas(TTF_Font* font) {
+    auto& slot = glyph_atlases[font];
+    if (!slot) slot = std::make_unique<glyph_atlas>(renderer, font);
+    return slot.get();
+}
+
+bool texture_manager::layout_glyph_text(TextEntry& e) {
+    TTF_Font* font = get_or_load_font(e.family, e.ptsize);
+    if (!font) return false;
+    return get_glyph_atlas(font)->layout(e.text, e.color, e.run);
+}
+
+void texture_manager::text_changed(TextEntry& e) {
+    ++e.generation;
+    if (text_listener) text_listener(e.name);
 }
 
 // Build or rebuild the SDL_Texture for a TextEntry
 bool texture_manager::rerender_text_texture(TextEntry& e) {
+    if (e.glyph_mode) {
+        if (!layout_glyph_text(e)) return false;
+        text_changed(e);
+        return true;
+    }
+
     TTF_Font* font = get_or_load_font(e.family, e.ptsize);
     if (!font) return false;
 
@@ -194,8 +846,9 @@ bool texture_manager::rerender_text_texture(TextEntry& e) {
     }
 
     // --- compute outer size ---
-    const int bw = e.border_enabled ? e.border_thickness : 0;
-    const int padw = e.pad_x, padh = e.pad_y;
+    const bool framed = !e.layered; // layered: background and border are drawn by the owner, texture holds text only
+    const int bw = (framed && e.border_enabled) ? e.border_thickness : 0;
+    const int padw = framed ? e.pad_x : 0, padh = framed ? e.pad_y : 0;
     const int inner_w = text->w + 2*padw;
     const int inner_h = text->h + 2*padh;
     const int out_w   = inner_w + 2*bw;
@@ -213,14 +866,14 @@ bool texture_manager::rerender_text_texture(TextEntry& e) {
     SDL_FillSurfaceRect(out, nullptr, transparent);
 
     // Background (if enabled)
-    if (e.bg_enabled && e.bg_color.a > 0) {
+    if (framed && e.bg_enabled && e.bg_color.a > 0) {
         SDL_Rect bg{ bw, bw, inner_w, inner_h };
         Uint32 bgpx = SDL_MapSurfaceRGBA(out, e.bg_color.r, e.bg_color.g, e.bg_color.b, e.bg_color.a);
         SDL_FillSurfaceRect(out, &bg, bgpx);
     }
 
     // Border (if enabled)
-    if (e.border_enabled && bw > 0 && e.border_color.a > 0) {
+    if (framed && e.border_enabled && bw > 0 && e.border_color.a > 0) {
         Uint32 bpx = SDL_MapSurfaceRGBA(out, e.border_color.r, e.border_color.g, e.border_color.b, e.border_color.a);
         SDL_Rect top   { 0,           0,        out_w, bw };
         SDL_Rect bottom{ 0,  out_h - bw,        out_w, bw };
@@ -235,8 +888,10 @@ bool texture_manager::rerender_text_texture(TextEntry& e) {
     SDL_BlitSurface(text, nullptr, out, &dst);
 
     // Replace existing texture
-    if (auto it = textures.find(e.name); it != textures.end() && it->second) {
-        SDL_DestroyTexture(it->second);
+    if (auto it = textures.find(e.name); it != textures.end() && it->second.region.tex && it->second.region.page < 0) {
+        SDL_DestroyTexture(it->second.region.tex);
+        it->second.region.tex = nullptr;
+        memory_used -= it->second.bytes;
     }
     SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, out);
     SDL_DestroySurface(text);
@@ -246,50 +901,102 @@ bool texture_manager::rerender_text_texture(TextEntry& e) {
         return false;
     }
     SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
-    textures[e.name] = tex;
+    put_texture(e.name, { tex, { 0, 0, (float)out_w, (float)out_h }, -1 });
+    text_changed(e);
     return true;
 }
 
 
-SDL_Texture* texture_manager::create_text_texture(const std::string& name, const std::string& family, float ptsize, const std::string& text, const SDL_Color& color, const SDL_Color& bg_color,  int wrap_width, const std::string& quality) {
+const texture_manager::TextEntry* texture_manager::create_text(const std::string& name, const std::string& text, const text_style& style) {
     TextEntry meta;
+    static_cast<text_style&>(meta) = style;
     meta.name = name;
-    meta.family = family;
-    meta.ptsize = ptsize;
     meta.text = text;
-    meta.color = color;
-    if (bg_color.a > 0) {
-        meta.bg_enabled = true;
-        meta.bg_color = bg_color;
-    }
-    meta.wrap_width = wrap_width;
-    meta.quality = quality;
 
     if (!rerender_text_texture(meta)) return nullptr;
-    text_meta[name] = std::move(meta);
-    return textures[name];
+    auto& stored = text_meta[name] = std::move(meta);
+    return &stored;
+}
+
+SDL_Texture* texture_manager::create_text_texture(const std::string& name, const std::string& family, float ptsize, const std::string& text, const SDL_Color& color, const SDL_Color& bg_color,  int wrap_width, const std::string& quality) {
+    text_style style(family, ptsize);
+    style.fg(color).wrap(wrap_width);
+    if (bg_color.a > 0) style.background(bg_color);
+
+    if (!create_text(name, text, style)) return nullptr;
+    text_meta.find(name)->second.quality = quality;
+    return get_texture(name);
 }
 
+const glyph_run* texture_manager::create_glyph_text(const std::string& name, const std::string& family, float ptsize, const std::string& text, const SDL_Color& color) {
+    const TextEntry* e = create_text(name, text, text_style(family, ptsize).fg(color).as_glyphs());
+    return e ? &e->run : nullptr;
+}
+
+bool texture_manager::set_text_layered(const std::string& name, bool layered) {
+    auto it = text_meta.find(name); if (it == text_meta.end()) return false;
+    if (it->second.layered == layered) return true;
+    it->second.layered = layered;
+    return refresh_text(it->second);
+}
+
+const texture_manager::TextEntry* texture_manager::get_text_entry(std::string_view name) const {
+    auto it = text_meta.find(name);
+    return (it != text_meta.end()) ? &it->second : nullptr;
+}
+
+const glyph_run* texture_manager::get_glyph_run(const std::string& name) const {
+    auto it = text_meta.find(name);
+    return (it != text_meta.end() && it->second.glyph_mode) ? &it->second.run : nullptr;
+}
+
+bool texture_manager::refresh_text(TextEntry& e) {
+    if (e.edit_depth > 0) {
+        e.edit_dirty = true;
+        return true;
+    }
+    return rerender_text_texture(e);
+}
+
+bool texture_manager::begin_text_edit(const std::string& name) {
+    auto it = text_meta.find(name); if (it == text_meta.end()) return false;
+    ++it->second.edit_depth;
+    return true;
+}
+
+bool texture_manager::commit_text_edit(const std::string& name) {
+    auto it = text_meta.find(name); if (it == text_meta.end()) return false;
+    TextEntry& e = it->second;
+    if (e.edit_depth == 0) return true;
+    if (--e.edit_depth > 0 || !e.edit_dirty) return true; // nested, or nothing changed
+    e.edit_dirty = false;
+    return rerender_text_texture(e);
+}
 
 bool texture_manager::set_text_string(const std::string& name, const std::string& new_text) {
     auto it = text_meta.find(name); if (it == text_meta.end()) return false;
     if (it->second.text == new_text) return true; //skip
     it->second.text = new_text;
-    return rerender_text_texture(it->second);
+    return refresh_text(it->second);
 }
 
 bool texture_manager::set_text_color(const std::string& name, SDL_Color new_color) {
     auto it = text_meta.find(name); if (it == text_meta.end()) return false;
     if (!std::memcmp(&it->second.color, &new_color, sizeof(SDL_Color))) return true;
     it->second.color = new_color;
-    return rerender_text_texture(it->second);
+    if (it->second.glyph_mode) { // vertex colors only
+        it->second.run.recolor(new_color);
+        text_changed(it->second);
+        return true;
+    }
+    return refresh_text(it->second);
 }
 
 bool texture_manager::set_text_size(const std::string& name, float new_ptsize) {
     auto it = text_meta.find(name); if (it == text_meta.end()) return false;
     if (it->second.ptsize == new_ptsize) return true;
     it->second.ptsize = new_ptsize;
-    return rerender_text_texture(it->second);
+    return refresh_text(it->second);
 }
 
 bool texture_manager::set_text_background(const std::string& name, bool enabled, SDL_Color color, int pad_x, int pad_y) {
@@ -300,7 +1007,11 @@ bool texture_manager::set_text_background(const std::string& name, bool enabled,
         it->second.pad_x = pad_x;
         it->second.pad_y = pad_y;
     }
-    return rerender_text_texture(it->second);
+    if (!it->second.composited()) { // frame is drawn from these fields every frame
+        text_changed(it->second);
+        return true;
+    }
+    return refresh_text(it->second);
 }
 
 bool texture_manager::set_text_background_const_padding(const std::string& name, bool enabled, SDL_Color color) {
@@ -309,14 +1020,18 @@ bool texture_manager::set_text_background_const_padding(const std::string& name,
     if (enabled) {
         it->second.bg_color = color;
     }
-    return rerender_text_texture(it->second);
+    if (!it->second.composited()) { // frame is drawn from these fields every frame
+        text_changed(it->second);
+        return true;
+    }
+    return refresh_text(it->second);
 }
 
 bool texture_manager::set_text_wrap(const std::string& name, int new_wrap) {
     auto it = text_meta.find(name); if (it == text_meta.end()) return false;
     if (it->second.wrap_width == new_wrap) return true;
     it->second.wrap_width = new_wrap;
-    return rerender_text_texture(it->second);
+    return refresh_text(it->second);
 }
 
 bool texture_manager::set_text_border(const std::string& name, bool enabled, SDL_Color color, int thickness) {
@@ -326,10 +1041,29 @@ bool texture_manager::set_text_border(const std::string& name, bool enabled, SDL
         it->second.border_color = color;
         it->second.border_thickness = thickness;
     }
-    return rerender_text_texture(it->second);
+    if (!it->second.composited()) { // frame is drawn from these fields every frame
+        text_changed(it->second);
+        return true;
+    }
+    return refresh_text(it->second);
 }
 
 SDL_Color& texture_manager::get_bg_color(const std::string& name) {
     auto it = text_meta.find(name);
     return it->second.bg_color;
-}
\ No newline at end of file
+}
+
+SDL_FPoint texture_manager::text_box_size(std::string_view name) const {
+    auto it = text_meta.find(name);
+    if (it == text_meta.end()) return { 0, 0 };
+    const TextEntry& e = it->second;
+    SDL_FPoint inner{ e.run.w, e.run.h };
+    if (!e.glyph_mode) {
+        auto tex = textures.find(name); // sizes only, no need to make it resident
+        if (tex == textures.end()) return { 0, 0 };
+        inner = { tex->second.region.src.w, tex->second.region.src.h };
+        if (e.composited()) return inner;
+    }
+    const int bw = e.border_enabled ? e.border_thickness : 0;
+    return { inner.x + 2.0f * (e.pad_x + bw), inner.y + 2.0f * (e.pad_y + bw) };
+}
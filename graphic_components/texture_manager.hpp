@@ -4,60 +4,278 @@
 #include <iostream>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
 #include <filesystem>
+#include <future>
 #include <algorithm>
+#include <functional>
 #include <SDL3/SDL.h>
 #include <SDL3_image/SDL_image.h>
 #include <SDL3_ttf/SDL_ttf.h>
+#include "glyph_cache.hpp"
+#include "asset_pack.hpp"
+#include "asset_watcher.hpp"
 
 using namespace std;
 
+// transparent hash so string_view / literal lookups don't build a std::string
+struct string_hash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+template<class V>
+using string_map = std::unordered_map<std::string, V, string_hash, std::equal_to<>>;
+
+// where a texture key lives: its own texture, or a sub-rect of a shared atlas page
+struct texture_region {
+    SDL_Texture* tex = nullptr;
+    SDL_FRect    src{ 0,0,0,0 };
+    int          page = -1; // index into atlas_pages, -1 if the texture is owned by this entry
+};
+
+class texture_manager;
+class texture_ref;
+
+struct font_cache_stats {
+    size_t file_reads = 0; // font files read from disk
+    size_t opens = 0;      // TTF fonts opened, one per (family, size)
+};
+
+struct texture_memory_stats {
+    size_t budget = 0;    // bytes, 0 = unlimited
+    size_t used = 0;      // bytes of resident textures and atlas pages
+    size_t evictions = 0;
+    size_t reloads = 0;
+};
+
+// how a text entry looks, built up front and rasterized once by create_text
+// text_style("fonts/ARIAL.TTF", 48).fg(Colors::white).background(Colors::light_grey, 4, 4).border(Colors::black, 2)
+struct text_style {
+    std::string family;
+    float       ptsize = 16;
+    SDL_Color   color{ 255,255,255,255 };
+    int         wrap_width = 0;
+    bool        bg_enabled = false;
+    SDL_Color   bg_color{ 0,0,0,0 };
+    bool        border_enabled = false;
+    SDL_Color   border_color{ 0,0,0,0 };
+    int         border_thickness = 0;
+    int         pad_x = 0, pad_y = 0;
+    bool        glyph_mode = false; // drawn as quads from a glyph atlas, never rasterized as a whole
+    bool        layered = false;    // texture holds only the text, owner draws background/border as solid rects
+
+    text_style() = default;
+    text_style(std::string family_in, float pt) : family(std::move(family_in)), ptsize(pt) {}
+
+    text_style& size(float pt) { ptsize = pt; return *this; }
+    text_style& fg(SDL_Color c) { color = c; return *this; }
+    text_style& background(SDL_Color c, int px = 0, int py = 0) { bg_enabled = true; bg_color = c; pad_x = px; pad_y = py; return *this; }
+    text_style& border(SDL_Color c, int thickness = 1) { border_enabled = true; border_color = c; border_thickness = thickness; return *this; }
+    text_style& wrap(int width) { wrap_width = width; return *this; }
+    text_style& as_layered(bool v = true) { layered = v; return *this; }
+    text_style& as_glyphs(bool v = true) { glyph_mode = v; return *this; }
+};
+
 class texture_manager {
-	unordered_map<string, SDL_Texture*> textures;
-    unordered_map<std::string, TTF_Font*> fonts;
+    friend class texture_ref;
+
+    struct texture_entry {
+        texture_region region; // region.tex is nullptr while evicted, page entries read it from their page
+        std::string source;    // file to reload from, empty = pinned (text, generated)
+        size_t bytes = 0;      // size when resident, atlas entries are counted on their page
+        int refs = 0;
+        Uint64 last_use = 0;
+    };
+	string_map<texture_entry> textures;
+    string_map<std::vector<std::string>> basename_index; // "s1" -> { "sprites/s1" }, more than one key = ambiguous
+    unordered_map<Uint64, TTF_Font*> fonts; // font_key(family id, size)
 	SDL_Renderer* renderer;
     SDL_Texture* missing_texture = nullptr;
-    struct TextEntry {
+
+    texture_entry& put_texture(const std::string& key, const texture_region& region, const std::string& source = {}); // every insert goes through here
+    auto erase_texture(decltype(textures)::iterator it) -> decltype(textures)::iterator;
+    void index_key(const std::string& key);
+    void unindex_key(const std::string& key);
+
+    //atlas
+    bool atlas_mode = false;
+    int atlas_page_size = 4096;
+    int atlas_padding = 2;
+    struct atlas_page {
+        SDL_Texture* tex = nullptr; // nullptr while evicted
+        int w = 0, h = 0;
+        size_t bytes = 0;
+        int refs = 0;               // sum of the refs of every entry on this page
+        Uint64 last_use = 0;
+        int pack_page = -1;         // page in the mapped pack, reloaded from there instead of files
+        std::vector<std::pair<std::string, SDL_Rect>> files; // what to blit where when the page is rebuilt
+    };
+    std::vector<atlas_page> atlas_pages;
+    std::unordered_map<std::string, texture_region> atlas_files; // file path -> packed region, dedupes overlapping folder loads
+
+    //image loading: collect on the caller, decode anywhere, upload on the render thread
+    struct decoded_image {
+        std::string key;
+        std::string path;
+        SDL_Surface* surf = nullptr;
+        bool alias = false; // file already decoded under another key
+    };
+    std::vector<decoded_image> pending_images;
+    std::vector<std::thread> decode_workers;
+    std::atomic<size_t> decode_next{ 0 };
+    std::atomic<size_t> decode_done{ 0 };
+
+    void collect_image_files(const std::string& folder_path, std::vector<decoded_image>& out);
+    static SDL_Surface* decode_image(const std::string& path);
+    void upload_decoded(std::vector<decoded_image>& images);
+    void drop_async_load();
+    void pack_atlas(std::vector<decoded_image>& images);
+
+    //pre-decoded pack, stays mapped so evicted pages can be uploaded again
+    asset_pack pack;
+    bool upload_pack_page(atlas_page& pg);
+
+    //hot reload: changed files decode on a worker, uploads go out in row bands spread over frames within reload_budget_ms
+    static constexpr size_t reload_band_bytes = 256 * 1024; // one SDL_UpdateTexture call, the most a frame can overrun by
+    struct reload_target {
+        int page = -1;               // same-size atlas slot, page texture looked up per band (it can be evicted meanwhile)
+        SDL_Texture* tex = nullptr;  // or a new standalone texture for key, swapped in once complete
+        std::string key;
+        SDL_Rect dst{ 0, 0, 0, 0 };
+    };
+    struct pending_reload {
+        std::string path;
+        std::future<SDL_Surface*> surf;
+        SDL_Surface* image = nullptr; // decoded, uploads in progress
+        std::vector<reload_target> targets;
+        size_t target = 0;
+        int row = 0;
+    };
+    std::unique_ptr<asset_watcher> watcher;
+    std::vector<std::string> changed_paths;
+    std::vector<pending_reload> reloads;
+    double reload_budget_ms = 2.0;
+    std::vector<Uint8> reload_scratch; // one band converted to a page's format
+    void plan_reload(pending_reload& r);
+    bool upload_reload_band(pending_reload& r); // true once every target is complete
+    void finish_reload(pending_reload& r, std::vector<std::string>& changed_keys);
+    void drop_reload(pending_reload& r);
+
+    //memory budget: unreferenced textures are evicted least recently used first and reloaded on the next lookup
+    size_t memory_budget = 0;
+    size_t memory_used = 0;
+    size_t eviction_count = 0;
+    size_t reload_count = 0;
+    Uint64 use_clock = 0;
+
+    static size_t texture_bytes(SDL_Texture* tex);
+    texture_region resident_region(const texture_entry& e) const;
+    bool make_resident(texture_entry& e);
+    bool reload_page(int page);
+    void enforce_budget(const texture_entry* keep = nullptr, int keep_page = -1);
+    void retain(const std::string& key);
+    void release(const std::string& key);
+public:
+    struct TextEntry : text_style {
         std::string name;
-        std::string family;
-        float       ptsize = 16;
-        SDL_Color   color{ 255,255,255,255 };
-        int         wrap_width = 0;
         std::string text;
         std::string quality = "blended";
-        bool        bg_enabled = false;
-        SDL_Color   bg_color{ 0,0,0,0 };
-        bool        border_enabled = false;
-        SDL_Color   border_color{ 0,0,0,0 };
-        int         border_thickness = 0;
-        int         pad_x = 0, pad_y = 0;
+        glyph_run   run;
+        int         edit_depth = 0;     // >0 between begin_text_edit and commit_text_edit
+        bool        edit_dirty = false;
+        Uint32      generation = 0;     // bumped when the texture, glyph run or drawn frame changes
+
+        bool composited() const { return !glyph_mode && !layered; } // background/border baked into the texture
     };
-    std::unordered_map<std::string, TextEntry> text_meta;
+private:
+    string_map<TextEntry> text_meta;
 
-    static std::string font_key(const std::string& family, float pt);
+    //font files are loaded once per family and shared by every size opened from them
+    struct font_file {
+        std::string path;
+        void* data = nullptr;
+        size_t size = 0;
+    };
+    std::vector<font_file> font_files;  // indexed by family id
+    string_map<Uint32> font_family_ids;
+    font_cache_stats font_stat;
+
+    static Uint64 font_key(Uint32 family_id, float pt);
+    Uint32 font_family_id(const std::string& family);
+    const font_file* get_font_file(Uint32 family_id);
     TTF_Font* get_or_load_font(const std::string& family, float pt);
     bool rerender_text_texture(TextEntry& e);
+    bool refresh_text(TextEntry& e); // rerender now, or mark dirty inside an edit batch
+    std::function<void(const std::string&)> text_listener;
+    void text_changed(TextEntry& e); // bumps the generation and tells the listener
+
+    std::unordered_map<TTF_Font*, std::unique_ptr<glyph_atlas>> glyph_atlases; // one per (family, size)
+    glyph_atlas* get_glyph_atlas(TTF_Font* font);
+    bool layout_glyph_text(TextEntry& e);
 public:
     texture_manager(SDL_Renderer* renderer);
     ~texture_manager();
 
-    auto find_iter_by_name(const std::string& name) -> decltype(textures)::iterator;
-    auto find_iter_by_name(const std::string& name) const -> decltype(textures)::const_iterator;
+    auto find_iter_by_name(std::string_view name) -> decltype(textures)::iterator;
+    auto find_iter_by_name(std::string_view name) const -> decltype(textures)::const_iterator;
     SDL_Texture* load_texture(const string& name, const string& filename);
-    SDL_Texture* get_texture(const string& name) const;
+    SDL_Texture* get_texture(std::string_view name);  // reloads the texture if it was evicted
+    texture_region get_region(std::string_view name); // only stays valid while referenced, see acquire
+    texture_ref acquire(std::string_view name);       // keeps the texture resident for the lifetime of the ref
     void load_textures_from_folder(const string& folder_path);
+
+    //atlas mode: load_textures_from_folder packs images into shared pages instead of one texture per file
+    void set_atlas_mode(bool enabled, int page_size = 4096, int padding = 2) { atlas_mode = enabled; atlas_page_size = page_size; atlas_padding = padding; }
+    bool is_atlas_mode() const { return atlas_mode; }
+    size_t atlas_page_count() const { return atlas_pages.size(); }
+
+    //async loading: decode on worker threads while the caller keeps initializing, then upload in finish_async_load
+    void begin_async_load(const std::vector<std::string>& folder_paths, unsigned thread_count = 0);
+    float async_progress() const; // decoded / total, 1 when idle
+    bool async_ready() const;     // every file decoded, finish_async_load won't block
+    bool finish_async_load();     // joins the workers and uploads, call on the render thread
     void set_renderer(SDL_Renderer* rend) { renderer = rend; }
-    void unload_texture(const string& name);
-    bool has(const string& name);
+
+    //asset pack (see write_asset_pack): open maps the file, upload creates every page from the mapping
+    bool open_pack(const std::string& path, const std::vector<std::string>& source_folders); // false when there is no usable or up to date pack, load the folders instead
+    bool upload_pack();                      // render thread, after set_renderer
+
+    //hot reload of folder-loaded images, for iterating on art without restarting
+    void enable_hot_reload(const std::vector<std::string>& folders, double budget_ms = 2.0);
+    void disable_hot_reload();
+    bool hot_reload_enabled() const { return watcher != nullptr; }
+    size_t update_hot_reload(std::vector<std::string>& changed_keys); // once per frame on the render thread, appends keys whose texture was swapped
+
+    //memory budget in bytes, 0 = unlimited
+    void set_memory_budget(size_t bytes) { memory_budget = bytes; enforce_budget(); }
+    texture_memory_stats memory_stats() const { return { memory_budget, memory_used, eviction_count, reload_count }; }
+
+    void unload_texture(std::string_view name);
+    bool has(std::string_view name) const;
     void clear();
 
     //text
     TTF_Font* load_font(const std::string& family, float pt);
-    void        unload_font(const std::string& family, float pt);
+    bool        unload_font(const std::string& family, float pt); // false while glyph text still uses it
     bool        has_font(const std::string& family, float pt) const;
+    font_cache_stats font_stats() const { return font_stat; }
 
+    const TextEntry* create_text(const std::string& name, const std::string& text, const text_style& style); // single raster/layout
     SDL_Texture* create_text_texture(const std::string& name, const std::string& family, float ptsize, const std::string& text, const SDL_Color& color, const SDL_Color& bg_color = {0,0,0,0}, int wrap_width = 0, const std::string& quality = "blended");
 
+    //glyph text: same setters as above, but a change only rebuilds the quads, skips background/border/wrap
+    const glyph_run* create_glyph_text(const std::string& name, const std::string& family, float ptsize, const std::string& text, const SDL_Color& color);
+    const glyph_run* get_glyph_run(const std::string& name) const;
+
+    //layered text: only the text is rasterized, background/border setters become plain field updates
+    bool set_text_layered(const std::string& name, bool layered);
+    const TextEntry* get_text_entry(std::string_view name) const; // stable until clear()
+    void set_text_listener(std::function<void(const std::string&)> fn) { text_listener = std::move(fn); } // called with the entry name on every generation bump
+
     bool set_text_string(const std::string& name, const std::string& new_text);
     bool set_text_color(const std::string& name, SDL_Color new_color);
     bool set_text_size(const std::string& name, float new_ptsize);
@@ -66,6 +284,40 @@ public:
     bool set_text_background_const_padding(const std::string& name, bool enabled, SDL_Color color = { 0,0,0,0 });
     bool set_text_border(const std::string& name, bool enabled, SDL_Color color = { 0,0,0,0 }, int thickness = 1);
     SDL_Color& get_bg_color(const std::string& name);
+    SDL_FPoint text_box_size(std::string_view name) const; // text + padding + border, whatever the entry's mode
+
+    //edit batches: setters between begin and commit only record, commit rasterizes once
+    bool begin_text_edit(const std::string& name);
+    bool commit_text_edit(const std::string& name);
+};
+
+// one reference on a texture, copies take their own
+class texture_ref {
+    friend class texture_manager;
+    texture_manager* mgr = nullptr;
+    std::string key;
+    texture_region reg;
+
+    texture_ref(texture_manager* m, std::string k, const texture_region& r) : mgr(m), key(std::move(k)), reg(r) {}
+public:
+    texture_ref() = default;
+    texture_ref(const texture_ref& rhs) : mgr(rhs.mgr), key(rhs.key), reg(rhs.reg) { if (mgr) mgr->retain(key); }
+    texture_ref(texture_ref&& rhs) noexcept : mgr(rhs.mgr), key(std::move(rhs.key)), reg(rhs.reg) { rhs.mgr = nullptr; }
+    texture_ref& operator=(texture_ref rhs) noexcept {
+        std::swap(mgr, rhs.mgr);
+        std::swap(key, rhs.key);
+        std::swap(reg, rhs.reg);
+        return *this;
+    }
+    ~texture_ref() { reset(); }
+
+    void reset() {
+        if (mgr) mgr->release(key);
+        mgr = nullptr;
+    }
+    const texture_region& region() const { return reg; } // valid while this ref is held
+    const std::string& name() const { return key; }
+    explicit operator bool() const { return mgr != nullptr; }
 };
 
 #endif
\ No newline at end of file
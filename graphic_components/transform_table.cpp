@@ -0,0 +1,42 @@
+#include "transform_table.hpp"
+#include <algorithm>
+
+void transform_table::clear() {
+	lx.assign(1, 0.0);
+	ly.assign(1, 0.0);
+	wx.assign(1, 0.0);
+	wy.assign(1, 0.0);
+	parent.assign(1, 0);
+	dirty.assign(1, 0);
+	moved.assign(1, 0);
+	first_dirty = 1;
+}
+
+int transform_table::add(int parent_node, double local_x, double local_y) {
+	const int node = static_cast<int>(parent.size());
+	lx.push_back(local_x);
+	ly.push_back(local_y);
+	wx.push_back(0.0);
+	wy.push_back(0.0);
+	parent.push_back(parent_node);
+	dirty.push_back(1);
+	moved.push_back(0);
+	first_dirty = std::min(first_dirty, static_cast<size_t>(node));
+	return node;
+}
+
+void transform_table::update() {
+	const size_t n = parent.size();
+	for (size_t i = first_dirty; i < n; ++i) {
+		const int p = parent[i]; // p < i, already final
+		dirty[i] |= dirty[p];
+		wx[i] = wx[p] + lx[i];
+		wy[i] = wy[p] + ly[i];
+	}
+}
+
+void transform_table::clear_changed() {
+	std::fill(dirty.begin() + first_dirty, dirty.end(), Uint8(0));
+	std::fill(moved.begin() + first_dirty, moved.end(), Uint8(0));
+	first_dirty = parent.size();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#ifndef transform_table_hpp
+#define transform_table_hpp
+#include <iostream>
+#include <vector>
+#include <SDL3/SDL.h>
+
+// Flattened transform hierarchy. Nodes sit parent-before-child in plain arrays and node 0 is a fixed origin
+// every root hangs off, so world = world[parent] + local is a single forward pass without branches or recursion.
+class transform_table {
+	std::vector<double> lx, ly, wx, wy;
+	std::vector<int> parent;
+	std::vector<Uint8> dirty;
+	std::vector<Uint8> moved; // set_local since clear_changed, not inherited by children
+	size_t first_dirty = 0; // nodes before it are up to date
+public:
+	transform_table() { clear(); }
+
+	void clear();
+	int add(int parent_node, double local_x, double local_y); // parent_node 0 for roots, must already be added
+	size_t size() const { return parent.size(); }
+
+	void set_local(int node, double x, double y) {
+		lx[node] = x;
+		ly[node] = y;
+		dirty[node] = 1;
+		moved[node] = 1;
+		if (static_cast<size_t>(node) < first_dirty) first_dirty = node;
+	}
+
+	void update(); // recomputes from the first dirty node on, children inherit the dirty flag
+	size_t dirty_begin() const { return first_dirty; }
+	bool changed(size_t node) const { return dirty[node] != 0; } // valid after update() until clear_changed()
+	bool moved_locally(size_t node) const { return moved[node] != 0; } // own local offset was set, parent moves don't count
+	void clear_changed();
+
+	int parent_of(size_t node) const { return parent[node]; }
+	double world_x(size_t node) const { return wx[node]; }
+	double world_y(size_t node) const { return wy[node]; }
+};
+
+#endif
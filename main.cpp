@@ -2,41 +2,53 @@
 #include <SDL3/SDL_main.h>
 #include <SDL3_image/SDL_image.h>
 #include "game.hpp"
+#include "frame_pacer.hpp"
 #include <ctime>
 
 int main(int argc, char *argv[]) {
-	const int fps_max = 200;
-	const double target_dt = 1.0 / fps_max;
+	// offline: cpp_floppa_game --pack [--no-atlas] writes asset_pack_path from asset_folders and exits
+	if (argc > 1 && SDL_strcmp(argv[1], "--pack") == 0) {
+		const bool atlas = !(argc > 2 && SDL_strcmp(argv[2], "--no-atlas") == 0);
+		return write_asset_pack(asset_folders, asset_pack_path, atlas) ? 0 : 1;
+	}
+
+	// --fps N sets the cap (0 = off), --benchmark runs uncapped and never idles
+	int fps_max = 200;
+	bool benchmark = false;
+	for (int i = 1; i < argc; ++i) {
+		if (SDL_strcmp(argv[i], "--fps") == 0 && i + 1 < argc) fps_max = SDL_atoi(argv[++i]);
+		else if (SDL_strcmp(argv[i], "--benchmark") == 0) benchmark = true;
+	}
+	frame_pacer pacer(benchmark ? 0 : fps_max);
 	srand(std::time(nullptr));
 
 	Game game1;
 	game1.init("EPIC FLOPPA ROCK PAPER SCISSORS", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 3840, 2160, false);
-	Uint64 now = SDL_GetPerformanceCounter();
-	Uint64 last = now;
-	const double freq = static_cast<double>(SDL_GetPerformanceFrequency());
 	const double max_dt = 0.25;
+	const Sint32 idle_wait_ms = 250; // still wakes up now and then for hot reload polling
 	SDL_Cursor* default_cursor = SDL_GetDefaultCursor();
 	SDL_Cursor* pointer_cursor = SDL_CreateSystemCursor(SDL_SYSTEM_CURSOR_POINTER);
 	game1.set_cursors(default_cursor, pointer_cursor);
 
+	pacer.restart(); // loading isn't the first frame
 	while (game1.running()) {
-		now = SDL_GetPerformanceCounter();
-		double dt = static_cast<double>(now - last) / freq;
-		last = now;
-
+		double dt = pacer.begin_frame();
 		if (dt > max_dt) dt = max_dt;
 
 		game1.handleEvents();
 		game1.update(dt);
+		if (!benchmark && !game1.needs_redraw()) {
+			// nothing moved and no input: block instead of redrawing the same frame
+			game1.wait_for_events(idle_wait_ms);
+			pacer.restart(); // time spent idle doesn't count as frame time
+			continue;
+		}
 		game1.render();
 
-		double frame_time = static_cast<double>(SDL_GetPerformanceCounter() - now) / freq;
-		if (frame_time < target_dt) {
-			Uint32 ms = static_cast<Uint32>((target_dt - frame_time) * 1000.0);
-			if (ms > 0) SDL_Delay(ms);
-		}
+		pacer.end_frame();
 	}
 	SDL_DestroyCursor(pointer_cursor);
+	pacer.dump(std::cout);
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "object_pool.hpp"
+#include <new>
+
+object_pool& object_pool::instance() {
+	static object_pool pool;
+	return pool;
+}
+
+object_pool::~object_pool() {
+	for (void* b : blocks) ::operator delete(b);
+}
+
+void* object_pool::allocate(size_t bytes) {
+	const size_t cls = (bytes + granule - 1) / granule;
+	if (cls == 0 || cls > class_count) {
+		++stat.heap_fallbacks;
+		return ::operator new(bytes);
+	}
+	++stat.live;
+	++stat.allocations;
+
+	if (free_node* n = free_lists[cls - 1]) {
+		free_lists[cls - 1] = n->next;
+		return n;
+	}
+	const size_t size = cls * granule;
+	if (left < size) {
+		// the tail of the old block is dropped, it's smaller than one object
+		cursor = static_cast<char*>(::operator new(block_size));
+		left = block_size;
+		blocks.push_back(cursor);
+		stat.blocks = blocks.size();
+	}
+	void* p = cursor;
+	cursor += size;
+	left -= size;
+	return p;
+}
+
+void object_pool::deallocate(void* p, size_t bytes) {
+	if (!p) return;
+	const size_t cls = (bytes + granule - 1) / granule;
+	if (cls == 0 || cls > class_count) {
+		::operator delete(p);
+		return;
+	}
+	free_node* n = static_cast<free_node*>(p);
+	n->next = free_lists[cls - 1];
+	free_lists[cls - 1] = n;
+	--stat.live;
+}
+
+bool object_pool::trim() {
+	if (stat.live != 0) return false;
+	for (void* b : blocks) ::operator delete(b);
+	blocks.clear();
+	free_lists.fill(nullptr);
+	cursor = nullptr;
+	left = 0;
+	stat.blocks = 0;
+	return true;
+}
+
+const std::string& object_pool::intern(std::string_view name) {
+	if (auto it = names.find(name); it != names.end()) return *it->second;
+	auto owned = std::make_unique<std::string>(name);
+	const std::string& ref = *owned;
+	names.emplace(std::string_view(ref), std::move(owned));
+	return ref;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef object_pool_hpp
+#define object_pool_hpp
+#include <iostream>
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct object_pool_stats {
+	size_t blocks = 0;        // 64 KiB blocks held
+	size_t live = 0;          // objects currently allocated from the pool
+	size_t allocations = 0;   // served from the pool since start
+	size_t heap_fallbacks = 0; // too big for a size class
+};
+
+// Size-segregated free lists carved out of 64 KiB blocks. Every GameObject type is allocated here
+// (see GameObject::operator new), so objects of one type sit together and freeing one is a push onto its list.
+// Main thread only, like the rest of the object code.
+class object_pool {
+	static constexpr size_t block_size = 64 * 1024;
+	static constexpr size_t granule = 16;    // also the alignment every object gets
+	static constexpr size_t class_count = 64; // sizes up to 1 KiB, bigger goes to the heap
+
+	struct free_node { free_node* next; };
+	std::array<free_node*, class_count> free_lists{};
+	std::vector<void*> blocks;
+	char* cursor = nullptr;
+	size_t left = 0;
+	object_pool_stats stat;
+	std::unordered_map<std::string_view, std::unique_ptr<std::string>> names; // key views the owned string
+
+	object_pool() = default;
+public:
+	~object_pool();
+	object_pool(const object_pool&) = delete;
+	object_pool& operator=(const object_pool&) = delete;
+
+	static object_pool& instance();
+
+	void* allocate(size_t bytes);
+	void deallocate(void* p, size_t bytes);
+	bool trim(); // hands every block back at once, only when nothing is live (after a scene is torn down)
+	const std::string& intern(std::string_view name); // object names, shared by clones, live until exit
+	const object_pool_stats& stats() const { return stat; }
+};
+
+#endif